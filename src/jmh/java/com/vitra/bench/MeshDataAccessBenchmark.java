@@ -0,0 +1,145 @@
+package com.vitra.bench;
+
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.Warmup;
+import org.openjdk.jmh.infra.Blackhole;
+
+import java.lang.reflect.Field;
+import java.lang.reflect.Method;
+import java.nio.ByteBuffer;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * Per-draw cost of reading a mesh's vertex data and draw state, before and after MeshDataAccessor.
+ *
+ * Mixin is not available outside the game, so the benchmark runs against a stand-in with MeshData's
+ * shape: private fields for the vertex/index results and the draw state, plus the public getters an
+ * {@code @Accessor} mixin adds to the target class.
+ * - reflection: what BufferBuilderMixin did per build (getDeclaredField/setAccessible/get and
+ *   getDeclaredMethod/invoke, with boxed counts)
+ * - accessor: what it does now through BgfxMeshData
+ *
+ * Run with: ./gradlew jmh
+ */
+@State(Scope.Thread)
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(TimeUnit.NANOSECONDS)
+@Warmup(iterations = 3, time = 1)
+@Measurement(iterations = 5, time = 1)
+@Fork(1)
+public class MeshDataAccessBenchmark {
+
+    public enum DrawMode { QUADS, TRIANGLES }
+
+    public enum IndexType { SHORT, INT }
+
+    public record DrawState(int vertexCount, int indexCount, DrawMode mode, IndexType indexType) {
+    }
+
+    /**
+     * Stand-in for ByteBufferBuilder.Result.
+     */
+    public static final class Result {
+        private final ByteBuffer byteBuffer;
+
+        Result(ByteBuffer byteBuffer) {
+            this.byteBuffer = byteBuffer;
+        }
+
+        public ByteBuffer byteBuffer() {
+            return byteBuffer;
+        }
+    }
+
+    /**
+     * Stand-in for MeshData with the accessor methods MeshDataAccessor injects.
+     */
+    public static final class Mesh {
+        private final Result vertexBuffer;
+        private final Result indexBuffer;
+        private final DrawState drawState;
+
+        Mesh(Result vertexBuffer, Result indexBuffer, DrawState drawState) {
+            this.vertexBuffer = vertexBuffer;
+            this.indexBuffer = indexBuffer;
+            this.drawState = drawState;
+        }
+
+        public Result vitra$getVertexBuffer() {
+            return vertexBuffer;
+        }
+
+        public Result vitra$getIndexBuffer() {
+            return indexBuffer;
+        }
+
+        public DrawState vitra$getDrawState() {
+            return drawState;
+        }
+    }
+
+    private Mesh mesh;
+
+    @Setup
+    public void setup() {
+        ByteBuffer vertices = ByteBuffer.allocateDirect(4 * 28);
+        ByteBuffer indices = ByteBuffer.allocateDirect(6 * 2);
+        mesh = new Mesh(new Result(vertices), new Result(indices), new DrawState(4, 6, DrawMode.QUADS, IndexType.SHORT));
+    }
+
+    @Benchmark
+    public void reflection(Blackhole blackhole) throws ReflectiveOperationException {
+        Field vertexBufferField = mesh.getClass().getDeclaredField("vertexBuffer");
+        vertexBufferField.setAccessible(true);
+        Object vertexBufferResult = vertexBufferField.get(mesh);
+        Method byteBufferMethod = vertexBufferResult.getClass().getDeclaredMethod("byteBuffer");
+        ByteBuffer vertexBuffer = (ByteBuffer) byteBufferMethod.invoke(vertexBufferResult);
+
+        Field drawStateField = mesh.getClass().getDeclaredField("drawState");
+        drawStateField.setAccessible(true);
+        Object drawState = drawStateField.get(mesh);
+        Method vertexCountMethod = drawState.getClass().getDeclaredMethod("vertexCount");
+        Method indexCountMethod = drawState.getClass().getDeclaredMethod("indexCount");
+        Method modeMethod = drawState.getClass().getDeclaredMethod("mode");
+        Method indexTypeMethod = drawState.getClass().getDeclaredMethod("indexType");
+        int vertexCount = (Integer) vertexCountMethod.invoke(drawState);
+        int indexCount = (Integer) indexCountMethod.invoke(drawState);
+        DrawMode mode = (DrawMode) modeMethod.invoke(drawState);
+        IndexType indexType = (IndexType) indexTypeMethod.invoke(drawState);
+
+        Field indexBufferField = mesh.getClass().getDeclaredField("indexBuffer");
+        indexBufferField.setAccessible(true);
+        Object indexBufferResult = indexBufferField.get(mesh);
+        ByteBuffer indexBuffer = (ByteBuffer) indexBufferResult.getClass().getDeclaredMethod("byteBuffer").invoke(indexBufferResult);
+
+        consume(blackhole, vertexBuffer, indexBuffer, vertexCount, indexCount, mode, indexType);
+    }
+
+    @Benchmark
+    public void accessor(Blackhole blackhole) {
+        DrawState drawState = mesh.vitra$getDrawState();
+        Result vertexResult = mesh.vitra$getVertexBuffer();
+        Result indexResult = mesh.vitra$getIndexBuffer();
+        consume(blackhole, vertexResult != null ? vertexResult.byteBuffer() : null,
+            indexResult != null ? indexResult.byteBuffer() : null,
+            drawState.vertexCount(), drawState.indexCount(), drawState.mode(), drawState.indexType());
+    }
+
+    private static void consume(Blackhole blackhole, ByteBuffer vertexBuffer, ByteBuffer indexBuffer,
+                                int vertexCount, int indexCount, DrawMode mode, IndexType indexType) {
+        blackhole.consume(vertexBuffer);
+        blackhole.consume(indexBuffer);
+        blackhole.consume(vertexCount);
+        blackhole.consume(indexCount);
+        blackhole.consume(mode);
+        blackhole.consume(indexType);
+    }
+}
@@ -0,0 +1,158 @@
+package com.vitra.bench;
+
+import com.vitra.render.bgfx.BgfxPixelKernels;
+import org.lwjgl.system.MemoryUtil;
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.Warmup;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * BgfxPixelKernels against the byte-at-a-time ByteBuffer loops they replace, on square textures.
+ *
+ * The *Buffer benchmarks are the scalar loops BgfxGlTexture used for RGB8 and BGRA8 uploads, and
+ * the same pattern for the conversions that had no loop before (ABGR8, A8, fills).
+ *
+ * Run with: ./gradlew jmh
+ */
+@State(Scope.Thread)
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(TimeUnit.MICROSECONDS)
+@Warmup(iterations = 3, time = 1)
+@Measurement(iterations = 5, time = 1)
+@Fork(1)
+public class PixelKernelBenchmark {
+
+    @Param({"256", "1024", "4096"})
+    public int size;
+
+    private int pixels;
+    private ByteBuffer source;
+    private ByteBuffer destination;
+    private long sourceAddress;
+    private long destinationAddress;
+
+    @Setup
+    public void setup() {
+        pixels = size * size;
+        source = ByteBuffer.allocateDirect(pixels * 4).order(ByteOrder.nativeOrder());
+        destination = ByteBuffer.allocateDirect(pixels * 4).order(ByteOrder.nativeOrder());
+        for (int i = 0; i < source.capacity(); i++) {
+            source.put(i, (byte) (i * 31 + 7));
+        }
+        sourceAddress = MemoryUtil.memAddress(source);
+        destinationAddress = MemoryUtil.memAddress(destination);
+    }
+
+    @Benchmark
+    public ByteBuffer rgb8ToRgba8Kernel() {
+        BgfxPixelKernels.rgb8ToRgba8(sourceAddress, destinationAddress, pixels);
+        return destination;
+    }
+
+    @Benchmark
+    public ByteBuffer rgb8ToRgba8Buffer() {
+        ByteBuffer rgb = source.clear();
+        ByteBuffer rgba = destination.clear();
+        for (int i = 0; i < pixels; i++) {
+            rgba.put(rgb.get()); // R
+            rgba.put(rgb.get()); // G
+            rgba.put(rgb.get()); // B
+            rgba.put((byte) 0xFF); // A = 255
+        }
+        return rgba;
+    }
+
+    @Benchmark
+    public ByteBuffer swapRedBlueKernel() {
+        BgfxPixelKernels.swapRedBlue(sourceAddress, destinationAddress, pixels);
+        return destination;
+    }
+
+    @Benchmark
+    public ByteBuffer swapRedBlueBuffer() {
+        ByteBuffer bgra = source.clear();
+        ByteBuffer rgba = destination.clear();
+        for (int i = 0; i < pixels; i++) {
+            byte b = bgra.get();
+            byte g = bgra.get();
+            byte r = bgra.get();
+            byte a = bgra.get();
+
+            rgba.put(r);
+            rgba.put(g);
+            rgba.put(b);
+            rgba.put(a);
+        }
+        return rgba;
+    }
+
+    @Benchmark
+    public ByteBuffer reversePixelBytesKernel() {
+        BgfxPixelKernels.reversePixelBytes(sourceAddress, destinationAddress, pixels);
+        return destination;
+    }
+
+    @Benchmark
+    public ByteBuffer reversePixelBytesBuffer() {
+        ByteBuffer abgr = source.clear();
+        ByteBuffer rgba = destination.clear();
+        for (int i = 0; i < pixels; i++) {
+            byte a = abgr.get();
+            byte b = abgr.get();
+            byte g = abgr.get();
+            byte r = abgr.get();
+
+            rgba.put(r);
+            rgba.put(g);
+            rgba.put(b);
+            rgba.put(a);
+        }
+        return rgba;
+    }
+
+    @Benchmark
+    public ByteBuffer a8ToRgba8Kernel() {
+        BgfxPixelKernels.a8ToRgba8(sourceAddress, destinationAddress, pixels);
+        return destination;
+    }
+
+    @Benchmark
+    public ByteBuffer a8ToRgba8Buffer() {
+        ByteBuffer alpha = source.clear();
+        ByteBuffer rgba = destination.clear();
+        for (int i = 0; i < pixels; i++) {
+            rgba.put((byte) 0);
+            rgba.put((byte) 0);
+            rgba.put((byte) 0);
+            rgba.put(alpha.get());
+        }
+        return rgba;
+    }
+
+    @Benchmark
+    public ByteBuffer fill32Kernel() {
+        BgfxPixelKernels.fill32(destinationAddress, 0xFF336699, pixels);
+        return destination;
+    }
+
+    @Benchmark
+    public ByteBuffer fill32Buffer() {
+        ByteBuffer rgba = destination.clear();
+        for (int i = 0; i < pixels; i++) {
+            rgba.putInt(0xFF336699);
+        }
+        return rgba;
+    }
+}
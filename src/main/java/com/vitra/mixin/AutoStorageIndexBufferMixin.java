@@ -0,0 +1,53 @@
+package com.vitra.mixin;
+
+import com.mojang.blaze3d.buffers.GpuBuffer;
+import com.mojang.blaze3d.systems.RenderSystem;
+import com.mojang.blaze3d.vertex.VertexFormat;
+import com.vitra.render.bgfx.BgfxBuffer;
+import com.vitra.render.bgfx.BgfxSharedIndexBuffers;
+import org.spongepowered.asm.mixin.Mixin;
+import org.spongepowered.asm.mixin.Shadow;
+import org.spongepowered.asm.mixin.injection.At;
+import org.spongepowered.asm.mixin.injection.Inject;
+import org.spongepowered.asm.mixin.injection.callback.CallbackInfoReturnable;
+
+/**
+ * Serves RenderSystem's sequential index buffers from BgfxSharedIndexBuffers.
+ *
+ * Vanilla regenerates each AutoStorageIndexBuffer through GpuDevice.createBuffer() whenever a draw
+ * needs more indices, and that buffer would land in a 16-bit arena page even once it switches to
+ * 32-bit indices. Returning the shared static BGFX buffer instead keeps one copy per pattern and
+ * picks the index width from the vertex count (16-bit up to 65,536 vertices).
+ */
+@Mixin(RenderSystem.AutoStorageIndexBuffer.class)
+public class AutoStorageIndexBufferMixin {
+
+    @Shadow(remap = false)
+    private VertexFormat.IndexType type;
+
+    /**
+     * Return the shared buffer covering indexCount indices, and report its index width through type().
+     */
+    @Inject(method = "getBuffer(I)Lcom/mojang/blaze3d/buffers/GpuBuffer;", at = @At("HEAD"), cancellable = true, remap = false)
+    private void onGetBuffer(int indexCount, CallbackInfoReturnable<GpuBuffer> cir) {
+        BgfxSharedIndexBuffers.Pattern pattern = vitra$pattern();
+        int numVertices = pattern.vertexCount(indexCount);
+
+        BgfxBuffer buffer = BgfxSharedIndexBuffers.getBuffer(pattern, numVertices);
+        if (buffer != null) {
+            this.type = buffer.getIndexSize() == 4 ? VertexFormat.IndexType.INT : VertexFormat.IndexType.SHORT;
+            cir.setReturnValue(buffer);
+        }
+    }
+
+    private BgfxSharedIndexBuffers.Pattern vitra$pattern() {
+        Object self = this;
+        if (self == RenderSystem.getSequentialBuffer(VertexFormat.Mode.QUADS)) {
+            return BgfxSharedIndexBuffers.Pattern.QUADS;
+        }
+        if (self == RenderSystem.getSequentialBuffer(VertexFormat.Mode.LINES)) {
+            return BgfxSharedIndexBuffers.Pattern.LINES;
+        }
+        return BgfxSharedIndexBuffers.Pattern.SEQUENTIAL;
+    }
+}
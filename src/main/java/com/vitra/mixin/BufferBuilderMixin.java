@@ -3,9 +3,12 @@ package com.vitra.mixin;
 import com.mojang.blaze3d.vertex.BufferBuilder;
 import com.mojang.blaze3d.vertex.MeshData;
 import com.mojang.blaze3d.vertex.VertexFormat;
+import com.mojang.blaze3d.systems.RenderSystem;
 import com.vitra.render.bgfx.BgfxBufferCache;
-import com.vitra.render.bgfx.Util;
-import org.lwjgl.bgfx.BGFX;
+import com.vitra.render.bgfx.BgfxFrameGeometry;
+import com.vitra.render.bgfx.BgfxMeshData;
+import com.vitra.render.bgfx.BgfxSharedIndexBuffers;
+import com.vitra.render.bgfx.BgfxVertexLayouts;
 import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 import org.spongepowered.asm.mixin.Mixin;
@@ -16,13 +19,16 @@ import org.spongepowered.asm.mixin.injection.callback.CallbackInfoReturnable;
 import java.nio.ByteBuffer;
 
 /**
- * Intercepts BufferBuilder.end() to create BGFX vertex and index buffers.
+ * Intercepts BufferBuilder.end() to pack immediate-mode geometry into BGFX frame storage.
  *
  * This mixin acts as a bridge between Minecraft's BufferBuilder and BGFX:
  * 1. Intercept BufferBuilder.end() when MeshData is created
- * 2. Extract vertex and index data from MeshData
- * 3. Create BGFX buffers using Util.createVertexBuffer() and Util.createIndexBuffer()
- * 4. Store buffer handles in BgfxBufferCache for later use in draw calls
+ * 2. Extract vertex and index data from MeshData (typed accessors, see BgfxMeshData)
+ * 3. Pack the data into BgfxFrameGeometry (transient buffers, pooled dynamic buffers as fallback);
+ *    QUADS/LINES/TRIANGLE_FAN meshes without sorted indices use BgfxSharedIndexBuffers
+ * 4. Store the resulting range in BgfxBufferCache for later use in draw calls
+ *
+ * No immutable BGFX buffer is created per MeshData - ranges are recycled after bgfx_frame().
  *
  * NO custom vertex format conversion - BGFX handles all format details internally.
  *
@@ -34,19 +40,23 @@ public class BufferBuilderMixin {
     private static final Logger LOGGER = LoggerFactory.getLogger("BufferBuilderMixin");
 
     /**
-     * Intercept BufferBuilder.buildOrThrow() to create BGFX buffers when MeshData is built.
+     * Intercept BufferBuilder.buildOrThrow() to pack geometry when MeshData is built.
      *
      * Minecraft 1.21.8 signature: buildOrThrow()Lcom/mojang/blaze3d/vertex/MeshData;
      * Note: "end()" is a Yarn mapping alias, Mojang mapping is "buildOrThrow()"
      *
-     * This uses ONLY BGFX native methods via Util:
-     * - Util.createVertexBuffer() -> bgfx_create_vertex_buffer()
-     * - Util.createIndexBuffer() -> bgfx_create_index_buffer()
+     * This uses ONLY BGFX native methods via BgfxFrameGeometry:
+     * - bgfx_alloc_transient_vertex_buffer() / bgfx_alloc_transient_index_buffer()
+     * - bgfx_update_dynamic_*_buffer() when transient space is exhausted
+     *
+     * Section meshes built on worker threads are skipped here: BGFX transient
+     * allocation is only valid on the render thread, and sections are uploaded
+     * through VitraGpuDevice.createBuffer() instead.
      */
     @Inject(method = "buildOrThrow()Lcom/mojang/blaze3d/vertex/MeshData;", at = @At("RETURN"), remap = false)
     private void onEnd(CallbackInfoReturnable<MeshData> cir) {
         MeshData meshData = cir.getReturnValue();
-        if (meshData == null) {
+        if (meshData == null || !RenderSystem.isOnRenderThread()) {
             return;
         }
 
@@ -54,117 +64,45 @@ public class BufferBuilderMixin {
             // Store BufferBuilder -> MeshData association for endBatch interception
             BgfxBufferCache.putMeshData((BufferBuilder) (Object) this, meshData);
 
-            // Get vertex data from MeshData using reflection
-            // Note: MeshData fields are private in 1.21.8, need to access via reflection
-            ByteBuffer vertexBuffer = null;
-            int vertexCount = 0;
-            int indexCount = 0;
-            VertexFormat.Mode mode = null;
-
-            try {
-                // Access private vertexBuffer field
-                java.lang.reflect.Field vertexBufferField = meshData.getClass().getDeclaredField("vertexBuffer");
-                vertexBufferField.setAccessible(true);
-                Object vertexBufferResult = vertexBufferField.get(meshData);
-
-                // Get ByteBuffer from ByteBufferBuilder$Result
-                if (vertexBufferResult != null) {
-                    java.lang.reflect.Method byteBufferMethod = vertexBufferResult.getClass().getDeclaredMethod("byteBuffer");
-                    vertexBuffer = (ByteBuffer) byteBufferMethod.invoke(vertexBufferResult);
-                }
-
-                // Access private drawState field
-                java.lang.reflect.Field drawStateField = meshData.getClass().getDeclaredField("drawState");
-                drawStateField.setAccessible(true);
-                Object drawState = drawStateField.get(meshData);
-
-                // Get draw parameters from DrawState
-                if (drawState != null) {
-                    java.lang.reflect.Method vertexCountMethod = drawState.getClass().getDeclaredMethod("vertexCount");
-                    java.lang.reflect.Method indexCountMethod = drawState.getClass().getDeclaredMethod("indexCount");
-                    java.lang.reflect.Method modeMethod = drawState.getClass().getDeclaredMethod("mode");
-
-                    vertexCount = (Integer) vertexCountMethod.invoke(drawState);
-                    indexCount = (Integer) indexCountMethod.invoke(drawState);
-                    mode = (VertexFormat.Mode) modeMethod.invoke(drawState);
-                }
-            } catch (Exception e) {
-                LOGGER.error("Failed to access MeshData fields via reflection", e);
-                return;
-            }
+            // Typed field access via MeshDataAccessor (no reflection on the build path)
+            MeshData.DrawState drawState = BgfxMeshData.drawState(meshData);
+            ByteBuffer vertexBuffer = BgfxMeshData.vertexData(meshData);
+            int vertexCount = drawState.vertexCount();
+            int indexCount = drawState.indexCount();
+            VertexFormat.Mode mode = drawState.mode();
 
             if (vertexBuffer == null || vertexBuffer.remaining() == 0) {
-                LOGGER.trace("Empty vertex buffer, skipping BGFX buffer creation");
+                LOGGER.trace("Empty vertex buffer, skipping BGFX geometry packing");
                 return;
             }
 
             LOGGER.trace("BufferBuilder.end(): vertices={}, indices={}, mode={}",
                 vertexCount, indexCount, mode);
 
-            // Create BGFX vertex buffer using native method
-            // Util.createVertexBuffer() calls bgfx_create_vertex_buffer() directly
-            short vertexBufferHandle = Util.createVertexBuffer(
-                vertexBuffer,
-                BGFX.BGFX_BUFFER_NONE  // No special flags
-            );
+            // Sorted/explicit index data (null for sequential modes like QUADS)
+            ByteBuffer indexBuffer = indexCount > 0 ? BgfxMeshData.indexData(meshData) : null;
+            boolean index32 = drawState.indexType() == VertexFormat.IndexType.INT;
+
+            // Pack into this frame's transient geometry (pooled dynamic buffer if transient space ran out).
+            // Generated patterns reference the shared index buffer instead of uploading their own.
+            BgfxFrameGeometry.Range range = indexBuffer != null
+                ? BgfxFrameGeometry.allocate(vertexBuffer, vertexCount, BgfxVertexLayouts.get(drawState.format()),
+                    indexBuffer, indexCount, index32)
+                : BgfxFrameGeometry.allocate(vertexBuffer, vertexCount, BgfxVertexLayouts.get(drawState.format()),
+                    BgfxSharedIndexBuffers.pattern(mode));
 
-            if (!Util.isValidHandle(vertexBufferHandle)) {
-                LOGGER.warn("Failed to create BGFX vertex buffer");
+            if (range == null) {
+                LOGGER.warn("Failed to allocate frame geometry for {} vertices", vertexCount);
                 return;
             }
 
-            // Cache vertex buffer handle
-            BgfxBufferCache.putVertexBufferHandle(meshData, vertexBufferHandle);
+            BgfxBufferCache.putGeometry(meshData, range);
 
-            LOGGER.trace("Created BGFX vertex buffer: handle={} for MeshData hash={}",
-                vertexBufferHandle, System.identityHashCode(meshData));
-
-            // Create index buffer if mesh has indices
-            if (indexCount > 0) {
-                ByteBuffer indexBuffer = null;
-
-                try {
-                    // Access private indexBuffer field
-                    java.lang.reflect.Field indexBufferField = meshData.getClass().getDeclaredField("indexBuffer");
-                    indexBufferField.setAccessible(true);
-                    Object indexBufferResult = indexBufferField.get(meshData);
-
-                    // Get ByteBuffer from ByteBufferBuilder$Result
-                    if (indexBufferResult != null) {
-                        java.lang.reflect.Method byteBufferMethod = indexBufferResult.getClass().getDeclaredMethod("byteBuffer");
-                        indexBuffer = (ByteBuffer) byteBufferMethod.invoke(indexBufferResult);
-                    }
-                } catch (Exception e) {
-                    LOGGER.error("Failed to access index buffer via reflection", e);
-                }
-
-                if (indexBuffer == null) {
-                    // No sorted buffer, mesh might not have indices
-                    LOGGER.trace("No index buffer in MeshData");
-                    return;
-                }
-
-                // Create BGFX index buffer using native method
-                // Util.createIndexBuffer() calls bgfx_create_index_buffer() directly
-                short indexBufferHandle = Util.createIndexBuffer(
-                    indexBuffer,
-                    BGFX.BGFX_BUFFER_NONE  // No special flags
-                );
-
-                if (!Util.isValidHandle(indexBufferHandle)) {
-                    LOGGER.warn("Failed to create BGFX index buffer");
-                    return;
-                }
-
-                // Cache index buffer handle
-                BgfxBufferCache.putIndexBufferHandle(meshData, indexBufferHandle);
-
-                LOGGER.trace("Created BGFX index buffer: handle={} for MeshData hash={}",
-                    indexBufferHandle, System.identityHashCode(meshData));
-            }
+            LOGGER.trace("Packed frame geometry: transient={}, verts={}, indices={} for MeshData hash={}",
+                range.isTransient(), range.getNumVertices(), range.getNumIndices(), System.identityHashCode(meshData));
 
         } catch (Exception e) {
-            LOGGER.error("Exception creating BGFX buffers in BufferBuilder.end()", e);
+            LOGGER.error("Exception packing BGFX geometry in BufferBuilder.end()", e);
         }
     }
 
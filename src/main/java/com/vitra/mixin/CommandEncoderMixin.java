@@ -66,7 +66,7 @@ public class CommandEncoderMixin {
 
             // Upload the image data to BGFX texture
             BgfxTextureManager.uploadTextureData(bgfxTextureHandle, image, 0, 0, 0,
-                image.getWidth(), image.getHeight());
+                image.getWidth(), image.getHeight(), 0, 0);
 
             if (textureUploadCount <= 10) {
                 LOGGER.info("BGFX texture uploaded successfully: handle={}, size={}x{}",
@@ -116,7 +116,7 @@ public class CommandEncoderMixin {
 
             // Upload the image data to BGFX texture with offset
             BgfxTextureManager.uploadTextureData(bgfxTextureHandle, image, mipLevel, offsetX, offsetY,
-                width, height);
+                width, height, skipPixels, skipRows);
 
             if (textureUploadCount <= 10) {
                 LOGGER.info("BGFX texture region uploaded: handle={}, offset=({},{}), size={}x{}",
@@ -3,10 +3,10 @@ package com.vitra.mixin;
 import com.mojang.blaze3d.vertex.MeshData;
 import com.vitra.render.bgfx.BgfxBufferCache;
 import com.vitra.render.bgfx.BgfxDrawCallManager;
+import com.vitra.render.bgfx.BgfxFrameGeometry;
 import com.vitra.render.bgfx.BgfxManagers;
 import com.vitra.render.bgfx.Util;
 import net.minecraft.client.renderer.RenderType;
-import org.lwjgl.bgfx.BGFX;
 import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 import org.spongepowered.asm.mixin.Mixin;
@@ -25,9 +25,9 @@ import org.spongepowered.asm.mixin.injection.callback.CallbackInfo;
  *
  * Strategy:
  * 1. Get MeshData parameter (contains vertex/index buffers)
- * 2. Retrieve BGFX buffer handles from BgfxBufferCache
+ * 2. Retrieve the frame geometry range from BgfxBufferCache
  * 3. Get current render state and active shader
- * 4. Submit indexed draw call to BGFX via BgfxDrawCallManager
+ * 4. Submit the range to BGFX via BgfxDrawCallManager
  */
 @Mixin(RenderType.CompositeRenderType.class)
 public class CompositeRenderTypeMixin {
@@ -61,46 +61,12 @@ public class CompositeRenderTypeMixin {
                 return;
             }
 
-            // Get BGFX buffer handles from cache
-            short vertexBufferHandle = BgfxBufferCache.getVertexBufferHandle(meshData);
-            short indexBufferHandle = BgfxBufferCache.getIndexBufferHandle(meshData);
+            // Get frame geometry range packed by BufferBuilderMixin
+            BgfxFrameGeometry.Range range = BgfxBufferCache.getGeometry(meshData);
 
-            if (!Util.isValidHandle(vertexBufferHandle)) {
+            if (range == null) {
                 if (drawCallCount <= 10) {
-                    LOGGER.warn("Invalid vertex buffer handle for MeshData, skipping draw");
-                }
-                return;
-            }
-
-            // Get draw parameters from MeshData using reflection
-            int vertexCount = 0;
-            int indexCount = 0;
-
-            try {
-                // Access private drawState field
-                java.lang.reflect.Field drawStateField = meshData.getClass().getDeclaredField("drawState");
-                drawStateField.setAccessible(true);
-                Object drawState = drawStateField.get(meshData);
-
-                if (drawState != null) {
-                    java.lang.reflect.Method vertexCountMethod = drawState.getClass().getDeclaredMethod("vertexCount");
-                    java.lang.reflect.Method indexCountMethod = drawState.getClass().getDeclaredMethod("indexCount");
-
-                    vertexCount = (Integer) vertexCountMethod.invoke(drawState);
-                    indexCount = (Integer) indexCountMethod.invoke(drawState);
-
-                    if (drawCallCount <= 10) {
-                        LOGGER.info("Draw parameters: vertexCount={}, indexCount={}", vertexCount, indexCount);
-                    }
-                }
-            } catch (Exception e) {
-                LOGGER.error("Failed to access MeshData drawState via reflection", e);
-                return;
-            }
-
-            if (vertexCount == 0) {
-                if (drawCallCount <= 10) {
-                    LOGGER.warn("vertexCount is 0, skipping draw");
+                    LOGGER.warn("No frame geometry for MeshData, skipping draw");
                 }
                 return;
             }
@@ -119,44 +85,22 @@ public class CompositeRenderTypeMixin {
             }
 
             if (drawCallCount <= 10) {
-                LOGGER.info("Submitting BGFX draw: program={}, vb={}, ib={}, state=0x{}",
-                    programHandle, vertexBufferHandle, indexBufferHandle, Long.toHexString(state));
+                LOGGER.info("Submitting BGFX draw: program={}, verts={}, indices={}, transient={}, state=0x{}",
+                    programHandle, range.getNumVertices(), range.getNumIndices(), range.isTransient(),
+                    Long.toHexString(state));
             }
 
-            // Submit draw call to BGFX
-            if (indexCount > 0 && Util.isValidHandle(indexBufferHandle)) {
-                // Indexed draw
-                drawCallManager.submitIndexed(
-                    0,                  // viewId (default view)
-                    programHandle,      // BGFX shader program
-                    vertexBufferHandle, // BGFX vertex buffer
-                    indexBufferHandle,  // BGFX index buffer
-                    state,              // BGFX render state
-                    0,                  // startVertex
-                    vertexCount,        // numVertices
-                    0,                  // startIndex
-                    indexCount          // numIndices
-                );
-
-                if (drawCallCount <= 10 || drawCallCount % 100 == 0) {
-                    LOGGER.info("BGFX indexed draw submitted: call #{}, verts={}, indices={}",
-                        drawCallCount, vertexCount, indexCount);
-                }
-            } else {
-                // Non-indexed draw
-                drawCallManager.submitNonIndexed(
-                    0,                  // viewId (default view)
-                    programHandle,      // BGFX shader program
-                    vertexBufferHandle, // BGFX vertex buffer
-                    state,              // BGFX render state
-                    0,                  // startVertex
-                    vertexCount         // numVertices
-                );
-
-                if (drawCallCount <= 10 || drawCallCount % 100 == 0) {
-                    LOGGER.info("BGFX non-indexed draw submitted: call #{}, verts={}",
-                        drawCallCount, vertexCount);
-                }
+            // Submit straight from the frame geometry range (indexed if indices were packed)
+            drawCallManager.submitGeometry(
+                0,                  // viewId (default view)
+                programHandle,      // BGFX shader program
+                range,              // Transient or pooled dynamic range
+                state               // BGFX render state
+            );
+
+            if (drawCallCount <= 10 || drawCallCount % 100 == 0) {
+                LOGGER.info("BGFX draw submitted: call #{}, verts={}, indices={}",
+                    drawCallCount, range.getNumVertices(), range.getNumIndices());
             }
 
         } catch (Exception e) {
@@ -0,0 +1,26 @@
+package com.vitra.mixin;
+
+import com.mojang.blaze3d.vertex.ByteBufferBuilder;
+import com.mojang.blaze3d.vertex.MeshData;
+import org.spongepowered.asm.mixin.Mixin;
+import org.spongepowered.asm.mixin.gen.Accessor;
+
+/**
+ * Typed accessors for MeshData's private fields.
+ *
+ * Replaces per-call getDeclaredField()/setAccessible()/invoke() lookups: Mixin generates
+ * plain field reads, so no reflection or boxing happens on the build/draw path.
+ * Use through BgfxMeshData rather than casting directly.
+ */
+@Mixin(MeshData.class)
+public interface MeshDataAccessor {
+
+    @Accessor(value = "vertexBuffer", remap = false)
+    ByteBufferBuilder.Result vitra$getVertexBuffer();
+
+    @Accessor(value = "indexBuffer", remap = false)
+    ByteBufferBuilder.Result vitra$getIndexBuffer();
+
+    @Accessor(value = "drawState", remap = false)
+    MeshData.DrawState vitra$getDrawState();
+}
@@ -0,0 +1,26 @@
+package com.vitra.mixin;
+
+import com.mojang.blaze3d.vertex.MeshData;
+import com.vitra.render.bgfx.BgfxBufferCache;
+import org.spongepowered.asm.mixin.Mixin;
+import org.spongepowered.asm.mixin.injection.At;
+import org.spongepowered.asm.mixin.injection.Inject;
+import org.spongepowered.asm.mixin.injection.callback.CallbackInfo;
+
+/**
+ * Drops the frame geometry range cached for a MeshData when Minecraft closes it.
+ *
+ * MeshData.close() is the end of the mesh's CPU-side lifetime. BgfxBufferCache keys ranges by
+ * identity hash, which a MeshData built later in the frame may reuse.
+ */
+@Mixin(MeshData.class)
+public class MeshDataMixin {
+
+    /**
+     * Inject at HEAD of MeshData.close(), before the vertex/index ByteBufferBuilder results are freed.
+     */
+    @Inject(method = "close()V", at = @At("HEAD"), remap = false)
+    private void onClose(CallbackInfo ci) {
+        BgfxBufferCache.onMeshDataClosed((MeshData) (Object) this);
+    }
+}
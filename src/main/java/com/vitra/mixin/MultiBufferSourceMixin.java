@@ -4,6 +4,7 @@ import com.mojang.blaze3d.vertex.BufferBuilder;
 import com.mojang.blaze3d.vertex.MeshData;
 import com.vitra.render.bgfx.BgfxBufferCache;
 import com.vitra.render.bgfx.BgfxDrawCallManager;
+import com.vitra.render.bgfx.BgfxFrameGeometry;
 import com.vitra.render.bgfx.BgfxManagers;
 import com.vitra.render.bgfx.Util;
 import net.minecraft.client.renderer.MultiBufferSource;
@@ -23,7 +24,7 @@ import org.spongepowered.asm.mixin.injection.callback.CallbackInfo;
  * When endBatch() is called, all geometry for a RenderType has been built and is ready to draw.
  *
  * Uses ONLY BGFX native methods via BgfxDrawCallManager:
- * - drawCallManager.submitIndexed() -> bgfx_set_state() + bgfx_set_vertex_buffer() + bgfx_submit()
+ * - drawCallManager.submitGeometry() -> bgfx_set_state() + bgfx_set_transient_vertex_buffer() + bgfx_submit()
  */
 @Mixin(MultiBufferSource.BufferSource.class)
 public class MultiBufferSourceMixin {
@@ -41,12 +42,11 @@ public class MultiBufferSourceMixin {
      * We intercept it to extract the MeshData and submit to BGFX.
      *
      * Uses ONLY BGFX native methods via managers:
-     * - BufferBuilderMixin.getMeshData() -> get MeshData from BufferBuilder
-     * - BufferBuilderMixin.getVertexBufferHandle() -> cached BGFX buffer handle
-     * - BufferBuilderMixin.getIndexBufferHandle() -> cached BGFX buffer handle
+     * - BgfxBufferCache.getMeshData() -> get MeshData from BufferBuilder
+     * - BgfxBufferCache.getGeometry() -> frame geometry range for the MeshData
      * - GlStateManagerMixin.getStateTracker() -> BgfxStateTracker.getCurrentState()
      * - BgfxManagers.getShaderManager() -> BgfxShaderManager.getActiveProgram()
-     * - BgfxDrawCallManager.submitIndexed() -> bgfx_submit()
+     * - BgfxDrawCallManager.submitGeometry() -> bgfx_submit()
      */
     @Inject(method = "endBatch(Lnet/minecraft/client/renderer/RenderType;Lcom/mojang/blaze3d/vertex/BufferBuilder;)V",
             at = @At("HEAD"), remap = false)
@@ -61,36 +61,11 @@ public class MultiBufferSourceMixin {
                 return;
             }
 
-            // Get BGFX buffer handles (created in BufferBuilderMixin, cached in BgfxBufferCache)
-            short vertexBufferHandle = BgfxBufferCache.getVertexBufferHandle(meshData);
-            short indexBufferHandle = BgfxBufferCache.getIndexBufferHandle(meshData);
+            // Get frame geometry range (packed in BufferBuilderMixin, cached in BgfxBufferCache)
+            BgfxFrameGeometry.Range range = BgfxBufferCache.getGeometry(meshData);
 
-            if (!Util.isValidHandle(vertexBufferHandle)) {
-                LOGGER.trace("Invalid vertex buffer handle, skipping draw submission");
-                return;
-            }
-
-            // Get draw parameters from MeshData using reflection
-            // Note: MeshData fields are private in 1.21.8
-            int vertexCount = 0;
-            int indexCount = 0;
-
-            try {
-                // Access private drawState field
-                java.lang.reflect.Field drawStateField = meshData.getClass().getDeclaredField("drawState");
-                drawStateField.setAccessible(true);
-                Object drawState = drawStateField.get(meshData);
-
-                // Get draw parameters from DrawState
-                if (drawState != null) {
-                    java.lang.reflect.Method vertexCountMethod = drawState.getClass().getDeclaredMethod("vertexCount");
-                    java.lang.reflect.Method indexCountMethod = drawState.getClass().getDeclaredMethod("indexCount");
-
-                    vertexCount = (Integer) vertexCountMethod.invoke(drawState);
-                    indexCount = (Integer) indexCountMethod.invoke(drawState);
-                }
-            } catch (Exception e) {
-                LOGGER.error("Failed to access MeshData drawState via reflection", e);
+            if (range == null) {
+                LOGGER.trace("No frame geometry for MeshData, skipping draw submission");
                 return;
             }
 
@@ -105,37 +80,16 @@ public class MultiBufferSourceMixin {
                 return;
             }
 
-            // Submit draw call to BGFX
-            if (indexCount > 0 && Util.isValidHandle(indexBufferHandle)) {
-                // Indexed draw
-                drawCallManager.submitIndexed(
-                    0,                  // viewId (default view)
-                    programHandle,      // BGFX shader program
-                    vertexBufferHandle, // BGFX vertex buffer
-                    indexBufferHandle,  // BGFX index buffer
-                    state,              // BGFX render state
-                    0,                  // startVertex
-                    vertexCount,        // numVertices
-                    0,                  // startIndex
-                    indexCount          // numIndices
-                );
+            // Submit draw call to BGFX straight from the frame geometry range
+            drawCallManager.submitGeometry(
+                0,                  // viewId (default view)
+                programHandle,      // BGFX shader program
+                range,              // Transient or pooled dynamic range
+                state               // BGFX render state
+            );
 
-                LOGGER.trace("Submitted indexed draw: verts={}, indices={}, program={}, state=0x{}",
-                    vertexCount, indexCount, programHandle, Long.toHexString(state));
-            } else {
-                // Non-indexed draw
-                drawCallManager.submitNonIndexed(
-                    0,                  // viewId (default view)
-                    programHandle,      // BGFX shader program
-                    vertexBufferHandle, // BGFX vertex buffer
-                    state,              // BGFX render state
-                    0,                  // startVertex
-                    vertexCount         // numVertices
-                );
-
-                LOGGER.trace("Submitted non-indexed draw: verts={}, program={}, state=0x{}",
-                    vertexCount, programHandle, Long.toHexString(state));
-            }
+            LOGGER.trace("Submitted draw: verts={}, indices={}, program={}, state=0x{}",
+                range.getNumVertices(), range.getNumIndices(), programHandle, Long.toHexString(state));
 
         } catch (Exception e) {
             LOGGER.error("Exception in endBatch interception", e);
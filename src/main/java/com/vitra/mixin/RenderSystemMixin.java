@@ -147,6 +147,18 @@ public class RenderSystemMixin {
                 // Without this, BGFX may skip the view entirely
                 BGFX.bgfx_touch(0);
 
+                // Rebuild mips of textures whose level 0 was written this frame, on the mipmap pool
+                com.vitra.render.bgfx.BgfxMipmaps.flush();
+
+                // Texture writes staged this frame, merged per texture (queued behind pending commands)
+                com.vitra.render.bgfx.BgfxUploadCoalescer.flush();
+
+                // Resource commands queued by other threads, within the frame's budget
+                com.vitra.render.bgfx.BgfxRenderQueue.drain();
+
+                // Sort modes of the views drawn this frame (submission order for views with mixed draws)
+                com.vitra.render.bgfx.BgfxSortKeys.applyViewModes();
+
                 long bgfxStartTime = System.nanoTime();
                 int frameNum = BGFX.bgfx_frame(false);
                 long bgfxEndTime = System.nanoTime();
@@ -170,6 +182,8 @@ public class RenderSystemMixin {
                 } else if (verboseLog) {
                     LOGGER.info("[TRACE] Frame #{} submitted ({}ms frame, {}ms BGFX)",
                         frameNum, frameDelta, bgfxMs);
+                    LOGGER.info("[TRACE] Submits by sort mode: {}", com.vitra.render.bgfx.BgfxSortKeys.getStats());
+                    LOGGER.info("[TRACE] Texture uploads: {}", com.vitra.render.bgfx.BgfxUploadCoalescer.getStats());
                 }
 
                 // Warn if frame time is excessive
@@ -177,9 +191,21 @@ public class RenderSystemMixin {
                     LOGGER.warn("[PERFORMANCE] Frame #{} took {}ms - possible stutter or hang!", frameNum, frameDelta);
                 }
 
+                // Recycle this frame's transient/pooled geometry ranges
+                com.vitra.render.bgfx.BgfxFrameGeometry.endFrame();
+                com.vitra.render.bgfx.BgfxEncoders.endFrame();
+                com.vitra.render.bgfx.BgfxViews.endFrame();
+                com.vitra.render.bgfx.BgfxScissors.endFrame();
+                com.vitra.render.bgfx.BgfxBufferCache.endFrame();
+                com.vitra.render.bgfx.BgfxUniformBlocks.endFrame();
+
                 // Advance fence synchronization
                 com.vitra.render.bgfx.BgfxFence.advanceFrame();
 
+                // Destroy retired buffer handles and recycle arena ranges whose frame BGFX has finished consuming
+                com.vitra.render.bgfx.BgfxBufferLifetime.processRetired();
+                com.vitra.render.bgfx.BgfxBufferArena.endFrame();
+
             } catch (Exception e) {
                 LOGGER.error("╔════════════════════════════════════════════════════════════╗");
                 LOGGER.error("║  EXCEPTION DURING BGFX FRAME SUBMISSION                    ║");
@@ -102,6 +102,25 @@ public class VitraRenderer {
         if (!initialized) return;
 
         LOGGER.info("Shutting down Vitra BGFX renderer...");
+
+        // Release frame geometry pools, cached buffer handles and vertex layouts while BGFX is still alive
+        if (com.vitra.render.bgfx.Util.isInitialized()) {
+            com.vitra.render.bgfx.BgfxMipmaps.shutdown();
+            com.vitra.render.bgfx.BgfxRenderQueue.shutdown();
+            com.vitra.render.bgfx.BgfxUploadCoalescer.shutdown();
+            com.vitra.render.bgfx.BgfxEncoders.shutdown();
+            com.vitra.render.bgfx.BgfxViews.shutdown();
+            com.vitra.render.bgfx.BgfxFrameGeometry.shutdown();
+            com.vitra.render.bgfx.BgfxBufferArena.shutdown();
+            com.vitra.render.bgfx.BgfxSharedIndexBuffers.shutdown();
+            com.vitra.render.bgfx.BgfxProgramCache.shutdown();
+            com.vitra.render.bgfx.BgfxUniformBlocks.shutdown();
+            com.vitra.render.bgfx.BgfxUniformRegistry.shutdown();
+            com.vitra.render.bgfx.BgfxBufferCache.cleanup();
+            com.vitra.render.bgfx.BgfxVertexLayouts.shutdown();
+            com.vitra.render.bgfx.BgfxUploadPool.shutdown();
+        }
+
         initialized = false;
         windowHandle = 0L;
         LOGGER.info("Vitra renderer shutdown complete");
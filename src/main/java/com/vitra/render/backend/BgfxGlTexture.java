@@ -1,5 +1,11 @@
 package com.vitra.render.backend;
 
+import com.vitra.render.bgfx.BgfxPixelKernels;
+import com.vitra.render.bgfx.BgfxRenderQueue;
+import com.vitra.render.bgfx.BgfxUploadCoalescer;
+import com.vitra.render.bgfx.BgfxUploadPool;
+import it.unimi.dsi.fastutil.ints.Int2ObjectMap;
+import it.unimi.dsi.fastutil.ints.Int2ObjectMaps;
 import it.unimi.dsi.fastutil.ints.Int2ObjectOpenHashMap;
 import org.lwjgl.bgfx.BGFX;
 import org.lwjgl.bgfx.BGFXMemory;
@@ -11,35 +17,49 @@ import org.slf4j.LoggerFactory;
 
 import java.nio.ByteBuffer;
 import java.nio.IntBuffer;
+import java.util.concurrent.atomic.AtomicInteger;
 
 import static org.lwjgl.bgfx.BGFX.*;
 
 /**
  * Manages OpenGL texture IDs and their corresponding BGFX texture handles.
  * Based on VulkanMod's VkGlTexture architecture.
+ *
+ * Texture IDs are global, but bind and pixel store state is per thread, like a GL context per
+ * thread: a loader thread binding and uploading never changes what the render thread has bound.
+ * BGFX calls go through BgfxRenderQueue, so uploads from other threads run on the render thread
+ * in order, with their pixels staged first.
  */
 public class BgfxGlTexture {
     private static final Logger LOGGER = LoggerFactory.getLogger("BgfxGlTexture");
 
-    private static int ID_COUNTER = 1;
-    private static final Int2ObjectOpenHashMap<BgfxGlTexture> textureMap = new Int2ObjectOpenHashMap<>();
+    private static final AtomicInteger ID_COUNTER = new AtomicInteger(1);
+    private static final Int2ObjectMap<BgfxGlTexture> textureMap = Int2ObjectMaps.synchronize(new Int2ObjectOpenHashMap<>());
 
-    // Track currently bound texture (per OpenGL bind semantics)
-    private static int boundTextureId = 0;
-    private static BgfxGlTexture boundTexture = null;
-
-    // Track active texture unit (GL_TEXTURE0, GL_TEXTURE1, etc.)
-    private static int activeTexture = 0;
+    /**
+     * Bind and pixel store state of one thread.
+     */
+    private static final class ContextState {
+        // Track currently bound texture (per OpenGL bind semantics)
+        int boundTextureId = 0;
+        BgfxGlTexture boundTexture = null;
+
+        // Track active texture unit (GL_TEXTURE0, GL_TEXTURE1, etc.)
+        int activeTexture = 0;
+
+        // OpenGL pixel store parameters (for texture upload)
+        int unpackRowLength = 0;
+        int unpackSkipRows = 0;
+        int unpackSkipPixels = 0;
+        int unpackAlignment = 4;
+    }
 
-    // OpenGL pixel store parameters (for texture upload)
-    private static int unpackRowLength = 0;
-    private static int unpackSkipRows = 0;
-    private static int unpackSkipPixels = 0;
-    private static int unpackAlignment = 4;
+    private static final ThreadLocal<ContextState> context = ThreadLocal.withInitial(ContextState::new);
 
     // Instance fields for this texture
     public final int glId;
-    private short bgfxHandle = BGFX_INVALID_HANDLE;
+    // Written by queued commands on the render thread
+    private volatile short bgfxHandle = BGFX_INVALID_HANDLE;
 
     private int width = 0;
     private int height = 0;
@@ -47,6 +67,8 @@ public class BgfxGlTexture {
     private int bgfxFormat = BGFX_TEXTURE_FORMAT_RGBA8;
 
     private boolean needsAllocation = false;
+    // A BGFX texture was requested (it exists once the queued creation has run); set and read from any thread
+    private volatile boolean allocated = false;
     private int maxLevel = 0;
     private int minFilter = GL11.GL_NEAREST;
     private int magFilter = GL11.GL_NEAREST;
@@ -60,7 +82,7 @@ public class BgfxGlTexture {
      * Called by GlStateManager._genTexture()
      */
     public static int genTextureId() {
-        int id = ID_COUNTER++;
+        int id = ID_COUNTER.getAndIncrement();
         BgfxGlTexture texture = new BgfxGlTexture(id);
         textureMap.put(id, texture);
         LOGGER.debug("Generated texture ID: {}", id);
@@ -72,19 +94,20 @@ public class BgfxGlTexture {
      * Called by GlStateManager._bindTexture()
      */
     public static void bindTexture(int id) {
-        boundTextureId = id;
+        ContextState state = context.get();
+        state.boundTextureId = id;
 
         if (id == 0) {
-            boundTexture = null;
+            state.boundTexture = null;
             LOGGER.trace("Unbound texture (ID 0)");
             return;
         }
 
-        boundTexture = textureMap.get(id);
-        if (boundTexture == null) {
+        state.boundTexture = textureMap.get(id);
+        if (state.boundTexture == null) {
             LOGGER.warn("Attempted to bind non-existent texture ID: {}", id);
         } else {
-            LOGGER.trace("Bound texture ID: {} (BGFX handle: {})", id, boundTexture.bgfxHandle);
+            LOGGER.trace("Bound texture ID: {} (BGFX handle: {})", id, state.boundTexture.bgfxHandle);
         }
     }
 
@@ -105,8 +128,8 @@ public class BgfxGlTexture {
      * Called by GlStateManager._activeTexture()
      */
     public static void activeTexture(int textureUnit) {
-        activeTexture = textureUnit - GL30.GL_TEXTURE0;
-        LOGGER.trace("Active texture unit: {}", activeTexture);
+        context.get().activeTexture = textureUnit - GL30.GL_TEXTURE0;
+        LOGGER.trace("Active texture unit: {}", textureUnit - GL30.GL_TEXTURE0);
     }
 
     /**
@@ -116,6 +139,7 @@ public class BgfxGlTexture {
     public static void texImage2D(int target, int level, int internalFormat,
                                    int width, int height, int border,
                                    int format, int type, IntBuffer pixels) {
+        BgfxGlTexture boundTexture = context.get().boundTexture;
         if (boundTexture == null) {
             LOGGER.warn("texImage2D called with no texture bound!");
             return;
@@ -150,6 +174,8 @@ public class BgfxGlTexture {
      */
     public static void texSubImage2D(int target, int level, int xOffset, int yOffset,
                                       int width, int height, int format, int type, long pixels) {
+        ContextState state = context.get();
+        BgfxGlTexture boundTexture = state.boundTexture;
         if (boundTexture == null) {
             LOGGER.warn("texSubImage2D called with no texture bound!");
             return;
@@ -163,8 +189,8 @@ public class BgfxGlTexture {
         if (pixels != 0L) {
             // Calculate buffer size based on format
             int bytesPerPixel = getBytesPerPixel(format, type);
-            int rowLength = unpackRowLength != 0 ? unpackRowLength : width;
-            int offset = (unpackSkipRows * rowLength + unpackSkipPixels) * bytesPerPixel;
+            int rowLength = state.unpackRowLength != 0 ? state.unpackRowLength : width;
+            int offset = (state.unpackSkipRows * rowLength + state.unpackSkipPixels) * bytesPerPixel;
             int size = rowLength * height * bytesPerPixel;
 
             src = MemoryUtil.memByteBuffer(pixels + offset, size);
@@ -180,6 +206,7 @@ public class BgfxGlTexture {
      */
     public static void texSubImage2D(int target, int level, int xOffset, int yOffset,
                                       int width, int height, int format, int type, ByteBuffer pixels) {
+        BgfxGlTexture boundTexture = context.get().boundTexture;
         if (boundTexture == null) {
             LOGGER.warn("texSubImage2D called with no texture bound!");
             return;
@@ -197,6 +224,7 @@ public class BgfxGlTexture {
      * Called by GlStateManager._texParameter()
      */
     public static void texParameter(int target, int pname, int param) {
+        BgfxGlTexture boundTexture = context.get().boundTexture;
         if (boundTexture == null) {
             return;
         }
@@ -216,6 +244,7 @@ public class BgfxGlTexture {
      * Called by GlStateManager._getTexLevelParameter()
      */
     public static int getTexLevelParameter(int target, int level, int pname) {
+        BgfxGlTexture boundTexture = context.get().boundTexture;
         if (boundTexture == null) {
             return 0;
         }
@@ -233,31 +262,32 @@ public class BgfxGlTexture {
      * Called by GlStateManager._pixelStore()
      */
     public static void pixelStore(int pname, int param) {
+        ContextState state = context.get();
         switch (pname) {
             case GL11.GL_UNPACK_ROW_LENGTH -> {
-                unpackRowLength = param;
+                state.unpackRowLength = param;
                 LOGGER.trace("Set GL_UNPACK_ROW_LENGTH: {}", param);
             }
             case GL11.GL_UNPACK_SKIP_ROWS -> {
-                unpackSkipRows = param;
+                state.unpackSkipRows = param;
                 LOGGER.trace("Set GL_UNPACK_SKIP_ROWS: {}", param);
             }
             case GL11.GL_UNPACK_SKIP_PIXELS -> {
-                unpackSkipPixels = param;
+                state.unpackSkipPixels = param;
                 LOGGER.trace("Set GL_UNPACK_SKIP_PIXELS: {}", param);
             }
             case GL11.GL_UNPACK_ALIGNMENT -> {
-                unpackAlignment = param;
+                state.unpackAlignment = param;
                 LOGGER.trace("Set GL_UNPACK_ALIGNMENT: {}", param);
             }
         }
     }
 
     /**
-     * Get currently bound texture.
+     * Get the texture bound on the calling thread.
      */
     public static BgfxGlTexture getBoundTexture() {
-        return boundTexture;
+        return context.get().boundTexture;
     }
 
     // ========== Instance Methods ==========
@@ -300,13 +330,6 @@ public class BgfxGlTexture {
             return;
         }
 
-        // Destroy old texture if exists
-        if (bgfxHandle != BGFX_INVALID_HANDLE) {
-            LOGGER.debug("Destroying old texture handle {} for GL ID {}", bgfxHandle, glId);
-            bgfx_destroy_texture(bgfxHandle);
-            bgfxHandle = BGFX_INVALID_HANDLE;
-        }
-
         // Create new BGFX texture
         long flags = BGFX_TEXTURE_NONE | BGFX_SAMPLER_NONE;
 
@@ -326,23 +349,41 @@ public class BgfxGlTexture {
             flags |= BGFX_SAMPLER_V_CLAMP;
         }
 
-        bgfxHandle = bgfx_create_texture_2d(
-            width, height,
-            maxLevel > 0, // hasMips
-            1, // numLayers
-            bgfxFormat,
-            flags,
-            null // no initial data
-        );
+        // Parameters are captured now; the texture is created on the render thread
+        int width = this.width;
+        int height = this.height;
+        boolean hasMips = maxLevel > 0;
+        int bgfxFormat = this.bgfxFormat;
+        long textureFlags = flags;
+        // Writes staged for the old texture must not land in the new one
+        BgfxUploadCoalescer.release(this);
+        BgfxRenderQueue.execute(() -> {
+            // Destroy old texture if exists
+            if (bgfxHandle != BGFX_INVALID_HANDLE) {
+                LOGGER.debug("Destroying old texture handle {} for GL ID {}", bgfxHandle, glId);
+                bgfx_destroy_texture(bgfxHandle);
+                bgfxHandle = BGFX_INVALID_HANDLE;
+            }
 
-        if (bgfxHandle == BGFX_INVALID_HANDLE) {
-            LOGGER.error("FAILED to create BGFX texture for GL ID {}: {}x{}, format={}",
-                glId, width, height, bgfxFormat);
-        } else {
-            LOGGER.info("Created BGFX texture handle {} for GL ID {}: {}x{}, format={}",
-                bgfxHandle, glId, width, height, bgfxFormat);
-        }
+            bgfxHandle = bgfx_create_texture_2d(
+                width, height,
+                hasMips,
+                1, // numLayers
+                bgfxFormat,
+                textureFlags,
+                null // no initial data
+            );
+
+            if (bgfxHandle == BGFX_INVALID_HANDLE) {
+                LOGGER.error("FAILED to create BGFX texture for GL ID {}: {}x{}, format={}",
+                    glId, width, height, bgfxFormat);
+            } else {
+                LOGGER.info("Created BGFX texture handle {} for GL ID {}: {}x{}, format={}",
+                    bgfxHandle, glId, width, height, bgfxFormat);
+            }
+        });
 
+        allocated = true;
         needsAllocation = false;
     }
 
@@ -351,56 +392,82 @@ public class BgfxGlTexture {
      */
     private void uploadSubImage(int level, int xOffset, int yOffset,
                                  int width, int height, int format, int type, ByteBuffer pixels) {
-        if (bgfxHandle == BGFX_INVALID_HANDLE) {
-            LOGGER.warn("Cannot upload to invalid texture handle (GL ID {})", glId);
+        if (!allocated) {
+            LOGGER.warn("Cannot upload to unallocated texture (GL ID {})", glId);
             return;
         }
 
         // Format conversion if needed (RGB -> RGBA, BGRA -> RGBA, etc.)
-        ByteBuffer uploadBuffer = pixels;
-        boolean needsFree = false;
-
-        if (format == GL11.GL_RGB && bgfxFormat == BGFX_TEXTURE_FORMAT_RGBA8) {
-            uploadBuffer = convertRGBtoRGBA(pixels, width, height);
-            needsFree = true;
-        } else if (format == GL30.GL_BGRA && bgfxFormat == BGFX_TEXTURE_FORMAT_RGBA8) {
-            uploadBuffer = convertBGRAtoRGBA(pixels, width, height);
-            needsFree = true;
-        }
-
-        // Create BGFX memory and copy pixel data
-        BGFXMemory mem = bgfx_make_ref(uploadBuffer);
-
-        // Upload to BGFX texture
-        bgfx_update_texture_2d(
-            bgfxHandle,
-            (short) level,
-            (short) 0, // layer
-            (short) xOffset,
-            (short) yOffset,
-            (short) width,
-            (short) height,
-            mem,
-            (short) BGFX_TEXTURE_NONE
-        );
-
-        LOGGER.info("Uploaded {}x{} pixels to texture {} (BGFX handle {}) at offset ({}, {}), level {}",
-            width, height, glId, bgfxHandle, xOffset, yOffset, level);
-
-        // Free converted buffer if we allocated one
-        if (needsFree) {
-            MemoryUtil.memFree(uploadBuffer);
+        // Converted pixels are written into a pooled block that the coalescer takes over. Unconverted
+        // pixels belong to the caller, which may reuse them as soon as glTexSubImage returns, so those
+        // are copied. RGBA8 writes are staged in BgfxUploadCoalescer and merged at the end of the frame.
+        ByteBuffer converted = null;
+        if (bgfxFormat == BGFX_TEXTURE_FORMAT_RGBA8
+            && (format == GL11.GL_RGB || format == GL30.GL_BGRA || format == GL11.GL_ALPHA)) {
+            if (format == GL11.GL_RGB) {
+                converted = convertRGBtoRGBA(pixels, width, height);
+            } else if (format == GL30.GL_BGRA) {
+                converted = convertBGRAtoRGBA(pixels, width, height);
+            } else {
+                converted = convertAlphaToRGBA(pixels, width, height);
+            }
+            if (converted == null) {
+                return;
+            }
         }
+
+        if (converted != null) {
+            BgfxUploadCoalescer.writeBlock(this, this::getBgfxHandle, level, 4,
+                xOffset, yOffset, width, height, converted);
+            LOGGER.trace("Staged {}x{} pixels for texture {} at offset ({}, {}), level {}",
+                width, height, glId, xOffset, yOffset, level);
+            return;
+        }
+        if (bgfxFormat == BGFX_TEXTURE_FORMAT_RGBA8 && format == GL11.GL_RGBA
+            && pixels.remaining() >= width * height * 4) {
+            BgfxUploadCoalescer.write(this, this::getBgfxHandle, level, 4,
+                xOffset, yOffset, width, height, MemoryUtil.memAddress(pixels), width * 4);
+            LOGGER.trace("Staged {}x{} pixels for texture {} at offset ({}, {}), level {}",
+                width, height, glId, xOffset, yOffset, level);
+            return;
+        }
+
+        // Upload to BGFX texture; the pixels are staged, so the caller may reuse its buffer right away
+        BGFXMemory mem = bgfx_copy(pixels);
+        BgfxRenderQueue.execute(() -> {
+            if (bgfxHandle == BGFX_INVALID_HANDLE) {
+                LOGGER.warn("Cannot upload to invalid texture handle (GL ID {})", glId);
+                return;
+            }
+            bgfx_update_texture_2d(
+                bgfxHandle,
+                0, // layer
+                (byte) level,
+                (short) xOffset,
+                (short) yOffset,
+                (short) width,
+                (short) height,
+                mem,
+                (short) 0xFFFF // pitch: derived from width and format
+            );
+
+            LOGGER.trace("Uploaded {}x{} pixels to texture {} (BGFX handle {}) at offset ({}, {}), level {}",
+                width, height, glId, bgfxHandle, xOffset, yOffset, level);
+        });
     }
 
     /**
      * Destroy BGFX texture handle.
      */
     private void destroy() {
-        if (bgfxHandle != BGFX_INVALID_HANDLE) {
-            bgfx_destroy_texture(bgfxHandle);
-            bgfxHandle = BGFX_INVALID_HANDLE;
-        }
+        allocated = false;
+        BgfxUploadCoalescer.release(this);
+        BgfxRenderQueue.execute(() -> {
+            if (bgfxHandle != BGFX_INVALID_HANDLE) {
+                bgfx_destroy_texture(bgfxHandle);
+                bgfxHandle = BGFX_INVALID_HANDLE;
+            }
+        });
     }
 
     // ========== Setters for Texture Parameters ==========
@@ -474,21 +541,29 @@ public class BgfxGlTexture {
         return components * bytesPerComponent;
     }
 
+    /**
+     * Whether a source buffer holds pixelCount pixels; the upload covers the full rectangle, so shorter
+     * input would have BGFX read past the converted block.
+     */
+    private static boolean hasPixels(ByteBuffer pixels, int pixelCount, int bytesPerPixel) {
+        if (pixels.remaining() < (long) pixelCount * bytesPerPixel) {
+            LOGGER.warn("Texture upload of {} pixels has only {} bytes of {}-byte pixels, skipping",
+                pixelCount, pixels.remaining(), bytesPerPixel);
+            return false;
+        }
+        return true;
+    }
+
     /**
      * Convert RGB to RGBA (add alpha channel).
      */
     private static ByteBuffer convertRGBtoRGBA(ByteBuffer rgb, int width, int height) {
         int pixelCount = width * height;
-        ByteBuffer rgba = MemoryUtil.memAlloc(pixelCount * 4);
-
-        for (int i = 0; i < pixelCount; i++) {
-            rgba.put(rgb.get()); // R
-            rgba.put(rgb.get()); // G
-            rgba.put(rgb.get()); // B
-            rgba.put((byte) 0xFF); // A = 255
+        if (!hasPixels(rgb, pixelCount, 3)) {
+            return null;
         }
-
-        rgba.flip();
+        ByteBuffer rgba = BgfxUploadPool.acquire(pixelCount * 4);
+        BgfxPixelKernels.rgb8ToRgba8(MemoryUtil.memAddress(rgb), MemoryUtil.memAddress(rgba), pixelCount);
         return rgba;
     }
 
@@ -497,21 +572,24 @@ public class BgfxGlTexture {
      */
     private static ByteBuffer convertBGRAtoRGBA(ByteBuffer bgra, int width, int height) {
         int pixelCount = width * height;
-        ByteBuffer rgba = MemoryUtil.memAlloc(pixelCount * 4);
-
-        for (int i = 0; i < pixelCount; i++) {
-            byte b = bgra.get();
-            byte g = bgra.get();
-            byte r = bgra.get();
-            byte a = bgra.get();
-
-            rgba.put(r);
-            rgba.put(g);
-            rgba.put(b);
-            rgba.put(a);
+        if (!hasPixels(bgra, pixelCount, 4)) {
+            return null;
         }
+        ByteBuffer rgba = BgfxUploadPool.acquire(pixelCount * 4);
+        BgfxPixelKernels.swapRedBlue(MemoryUtil.memAddress(bgra), MemoryUtil.memAddress(rgba), pixelCount);
+        return rgba;
+    }
 
-        rgba.flip();
+    /**
+     * Convert ALPHA to RGBA (black color channels).
+     */
+    private static ByteBuffer convertAlphaToRGBA(ByteBuffer alpha, int width, int height) {
+        int pixelCount = width * height;
+        if (!hasPixels(alpha, pixelCount, 1)) {
+            return null;
+        }
+        ByteBuffer rgba = BgfxUploadPool.acquire(pixelCount * 4);
+        BgfxPixelKernels.a8ToRgba8(MemoryUtil.memAddress(alpha), MemoryUtil.memAddress(rgba), pixelCount);
         return rgba;
     }
 
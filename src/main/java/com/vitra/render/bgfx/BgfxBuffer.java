@@ -8,6 +8,7 @@ import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 
 import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 
 /**
  * Simplified BGFX buffer implementation that uses BGFX native functionality directly
@@ -27,6 +28,21 @@ public class BgfxBuffer extends GpuBuffer {
     // Store actual buffer size since parent class may modify it
     private final int actualSize;
 
+    // Bytes per vertex of the layout the BGFX vertex buffer was created with (0 for non-vertex buffers)
+    private final int vertexStride;
+
+    // Bytes per index (2 or 4) of the BGFX index buffer (0 for non-index buffers)
+    private final int indexSize;
+
+    // Range of a shared BgfxBufferArena page backing this buffer (null if the buffer owns its handle)
+    private final BgfxBufferArena.Allocation allocation;
+
+    // Handle owned by BgfxSharedIndexBuffers; closing this buffer leaves it alone
+    private final boolean shared;
+
+    // CPU copy of the contents for USAGE_COPY_SRC buffers (BgfxShadowStore), null otherwise
+    private ByteBuffer shadow;
+
     public enum BufferType {
         VERTEX_BUFFER("vertex_buffer"),
         INDEX_BUFFER("index_buffer"),
@@ -50,10 +66,14 @@ public class BgfxBuffer extends GpuBuffer {
      * BGFX handles all validation and creation internally.
      */
     public BgfxBuffer(String name, int numVertices, BGFXVertexLayout layout, int flags) {
-        super(numVertices * calculateVertexSize(layout), GpuBuffer.USAGE_VERTEX | GpuBuffer.USAGE_MAP_WRITE);
+        super(numVertices * Short.toUnsignedInt(layout.stride()), GpuBuffer.USAGE_VERTEX | GpuBuffer.USAGE_MAP_WRITE);
         this.name = name;
         this.type = BufferType.DYNAMIC_VERTEX_BUFFER;
-        this.actualSize = numVertices * calculateVertexSize(layout);
+        this.vertexStride = Short.toUnsignedInt(layout.stride());
+        this.indexSize = 0;
+        this.actualSize = numVertices * vertexStride;
+        this.allocation = null;
+        this.shared = false;
         this.bgfxHandle = BgfxOperations.createDynamicVertexBuffer(numVertices, layout, flags);
         this.cpuBuffer = null;
 
@@ -65,16 +85,39 @@ public class BgfxBuffer extends GpuBuffer {
      * BGFX handles all validation and creation internally.
      */
     public BgfxBuffer(String name, int numIndices, int flags) {
-        super(numIndices * 4, GpuBuffer.USAGE_INDEX | GpuBuffer.USAGE_MAP_WRITE);
+        super(numIndices * indexSize(flags), GpuBuffer.USAGE_INDEX | GpuBuffer.USAGE_MAP_WRITE);
         this.name = name;
         this.type = BufferType.DYNAMIC_INDEX_BUFFER;
-        this.actualSize = numIndices * 4;
+        this.vertexStride = 0;
+        this.indexSize = indexSize(flags);
+        this.actualSize = numIndices * indexSize;
+        this.allocation = null;
+        this.shared = false;
         this.bgfxHandle = BgfxOperations.createDynamicIndexBuffer(numIndices, flags);
         this.cpuBuffer = null;
 
         LOGGER.debug("Created dynamic index buffer: {} (handle: {}, size: {})", name, bgfxHandle, actualSize);
     }
 
+    /**
+     * Wrap a static index buffer owned by BgfxSharedIndexBuffers.
+     * Closing the wrapper does not destroy the BGFX handle.
+     */
+    BgfxBuffer(String name, short sharedHandle, int numIndices, boolean index32) {
+        super(numIndices * (index32 ? 4 : 2), GpuBuffer.USAGE_INDEX);
+        this.name = name;
+        this.type = BufferType.INDEX_BUFFER;
+        this.vertexStride = 0;
+        this.indexSize = index32 ? 4 : 2;
+        this.actualSize = numIndices * indexSize;
+        this.allocation = null;
+        this.shared = true;
+        this.bgfxHandle = sharedHandle;
+        this.cpuBuffer = null;
+
+        LOGGER.debug("Wrapped shared index buffer: {} (handle: {}, size: {})", name, bgfxHandle, actualSize);
+    }
+
     /**
      * Create a buffer based on usage flags (for compatibility with GpuDevice interface).
      * BGFX handles all validation and creation internally.
@@ -84,36 +127,59 @@ public class BgfxBuffer extends GpuBuffer {
         this.name = name;
         this.type = typeMarker != null ? typeMarker : mapUsageToBufferType(usage);
         this.actualSize = size;  // Store the ACTUAL size we want, not what parent class might modify
+        this.shared = false;
 
         LOGGER.info("BgfxBuffer constructor: name={}, size={}, usage=0x{}, typeMarker={}, detected type={}",
             name, size, Integer.toHexString(usage), typeMarker, this.type);
 
         if (this.type == BufferType.DYNAMIC_VERTEX_BUFFER) {
-            BGFXVertexLayout layout = BgfxOperations.getPositionTexColorLayout();
-            int numVertices = size / calculateVertexSize(layout);
-            this.bgfxHandle = BgfxOperations.createDynamicVertexBuffer(numVertices, layout, 0);
+            // The vertex format is only known at draw time (from the pipeline), so carve `size` bytes
+            // out of an untyped arena page and rebind with the real layout per draw
+            this.vertexStride = BgfxVertexLayouts.RAW_STRIDE;
+            this.indexSize = 0;
+            this.allocation = BgfxBufferArena.allocateVertex(size);
+            this.bgfxHandle = allocation != null ? allocation.getHandle() : BGFX.BGFX_INVALID_HANDLE;
             this.cpuBuffer = null;
         } else if (this.type == BufferType.DYNAMIC_INDEX_BUFFER) {
-            int numIndices = size / 4; // Assuming 32-bit indices
-            this.bgfxHandle = BgfxOperations.createDynamicIndexBuffer(numIndices, 0);
+            // Arena index pages hold 16-bit indices
+            this.vertexStride = 0;
+            this.indexSize = 2;
+            this.allocation = BgfxBufferArena.allocateIndex(size);
+            this.bgfxHandle = allocation != null ? allocation.getHandle() : BGFX.BGFX_INVALID_HANDLE;
             this.cpuBuffer = null;
         } else if (this.type == BufferType.UNIFORM_BUFFER) {
             // BGFX doesn't have OpenGL-style UBOs (Uniform Buffer Objects)
             // Emulate as CPU-side buffer - uniform values will be extracted and set per-draw
+            this.vertexStride = 0;
+            this.indexSize = 0;
+            this.allocation = null;
             this.bgfxHandle = BGFX.BGFX_INVALID_HANDLE;
             this.cpuBuffer = ByteBuffer.allocateDirect(size);
             LOGGER.info("Created CPU-emulated uniform buffer: {} (size: {}, cpuBuffer capacity: {})",
                 name, size, cpuBuffer.capacity());
         } else {
             LOGGER.warn("Unsupported buffer type: {} for buffer: {}", type, name);
+            this.vertexStride = 0;
+            this.indexSize = 0;
+            this.allocation = null;
             this.bgfxHandle = BGFX.BGFX_INVALID_HANDLE;
             this.cpuBuffer = null;
         }
 
+        // BGFX cannot read buffers back, so copy sources keep a CPU copy to serve copies from.
+        // Uniform buffers already live on the CPU.
+        if ((usage & USAGE_COPY_SRC) != 0 && type != BufferType.UNIFORM_BUFFER && bgfxHandle != BGFX.BGFX_INVALID_HANDLE) {
+            this.shadow = BgfxShadowStore.allocate(name, size);
+        }
+
         LOGGER.info("Buffer created: {} (handle: {}, type: {}, actualSize: {}, parent size(): {})",
             name, bgfxHandle, type, actualSize, super.size());
     }
 
+    private static int indexSize(int flags) {
+        return (flags & BGFX.BGFX_BUFFER_INDEX32) != 0 ? 4 : 2;
+    }
+
     private BufferType mapUsageToBufferType(int usage) {
         if ((usage & USAGE_INDEX) != 0) {
             return BufferType.DYNAMIC_INDEX_BUFFER;
@@ -126,16 +192,51 @@ public class BgfxBuffer extends GpuBuffer {
         }
     }
 
-    private static int calculateVertexSize(BGFXVertexLayout layout) {
-        // Estimate vertex size based on common layouts
-        // Position (3 floats) + TexCoord (2 floats) + Color (4 bytes) = 24 bytes
-        return 24;
-    }
-
     public short getBgfxHandle() {
         return bgfxHandle;
     }
 
+    /**
+     * Bytes per vertex of the layout this buffer was created with, or 0 if it is not a vertex buffer.
+     */
+    public int getVertexStride() {
+        return vertexStride;
+    }
+
+    /**
+     * Bytes per index (2 or 4) of the BGFX index buffer, or 0 if it is not an index buffer.
+     */
+    public int getIndexSize() {
+        return indexSize;
+    }
+
+    /**
+     * Byte offset of this buffer's data inside its BGFX buffer (non-zero for arena-backed buffers).
+     * Draws must bind from this offset.
+     */
+    public int getBaseOffset() {
+        return allocation != null ? allocation.getOffset() : 0;
+    }
+
+    /**
+     * Whether copies from this buffer can be served from CPU memory (see {@link #readShadow(int, int)}).
+     */
+    public boolean hasShadow() {
+        return shadow != null || cpuBuffer != null;
+    }
+
+    /**
+     * Window of the CPU copy of this buffer's contents, or null if the buffer has no
+     * shadow or the range is out of bounds. Valid until the buffer is next written or closed.
+     */
+    public ByteBuffer readShadow(int offset, int length) {
+        ByteBuffer source = shadow != null ? shadow : cpuBuffer;
+        if (source == null || closed || offset < 0 || length < 0 || offset + length > actualSize) {
+            return null;
+        }
+        return source.slice(offset, length).order(ByteOrder.nativeOrder());
+    }
+
     public BufferType getType() {
         return type;
     }
@@ -192,27 +293,47 @@ public class BgfxBuffer extends GpuBuffer {
             return true;
         }
 
-        return BgfxOperations.updateDynamicBuffer(bgfxHandle, offset, data,
-            type == BufferType.DYNAMIC_VERTEX_BUFFER || type == BufferType.VERTEX_BUFFER);
+        boolean isVertexBuffer = type == BufferType.DYNAMIC_VERTEX_BUFFER || type == BufferType.VERTEX_BUFFER;
+
+        // bgfx_update_dynamic_*_buffer() takes a start vertex/index, not a byte offset
+        boolean updated = BgfxOperations.updateDynamicBuffer(bgfxHandle, (getBaseOffset() + offset) / elementSize(), data, isVertexBuffer);
+
+        // Mirror into the shadow after BGFX has copied the data: it may be a window of this very shadow
+        if (shadow != null) {
+            shadow.put(offset, data, data.position(), data.remaining());
+        }
+        return updated;
     }
 
     /**
-     * Map buffer for CPU access.
-     * BGFX doesn't support direct memory mapping - we emulate it with a CPU-side buffer.
-     * On unmap, the data is copied to the BGFX buffer using bgfx_update_dynamic_*_buffer.
-     * For UNIFORM_BUFFER, returns the CPU-side buffer directly.
+     * Map the whole buffer for CPU access.
      */
     public MappedView map(boolean read, boolean write) {
+        return map(0, actualSize, read, write);
+    }
+
+    /**
+     * Map a byte range of the buffer for CPU access.
+     * BGFX doesn't support direct memory mapping - we emulate it with a pooled staging block.
+     * On unmap of a write mapping, the range that was written is uploaded with
+     * bgfx_update_dynamic_*_buffer, at its real offset inside the buffer; read-only mappings upload nothing.
+     * For UNIFORM_BUFFER, returns a window of the CPU-side buffer directly.
+     */
+    public MappedView map(int offset, int length, boolean read, boolean write) {
+        if (offset < 0 || length < 0 || offset + length > actualSize) {
+            throw new IllegalArgumentException(
+                String.format("Cannot map %d bytes at offset %d of buffer '%s' (size %d)", length, offset, name, actualSize));
+        }
+
         if (type == BufferType.UNIFORM_BUFFER && cpuBuffer != null) {
-            // For uniform buffers, return a view of the CPU-side buffer
+            // For uniform buffers, return a view of the mapped window of the CPU-side buffer
             return new MappedView() {
                 private boolean unmapped = false;
 
                 @Override
                 public ByteBuffer data() {
                     synchronized (cpuBuffer) {
-                        cpuBuffer.clear();
-                        return cpuBuffer;
+                        return cpuBuffer.slice(offset, length).order(ByteOrder.nativeOrder());
                     }
                 }
 
@@ -226,27 +347,105 @@ public class BgfxBuffer extends GpuBuffer {
             };
         }
 
-        // BGFX doesn't have direct memory mapping like OpenGL
-        // Return a CPU-side buffer that will be uploaded on unmap
-        ByteBuffer mappedBuffer = ByteBuffer.allocateDirect((int)size());
+        return new StagingView(offset, length, read, write);
+    }
 
-        return new MappedView() {
-            private boolean unmapped = false;
+    /**
+     * Bytes per element as BGFX addresses this buffer in bgfx_update_dynamic_*_buffer():
+     * the creation layout's stride for vertex buffers, the index width for index buffers.
+     */
+    private int elementSize() {
+        if (type == BufferType.DYNAMIC_VERTEX_BUFFER || type == BufferType.VERTEX_BUFFER) {
+            return Math.max(vertexStride, 1);
+        }
+        return Math.max(indexSize, 1);
+    }
 
-            @Override
-            public ByteBuffer data() {
-                return mappedBuffer;
+    /**
+     * Mapped window backed by a BgfxUploadPool block.
+     *
+     * Only write mappings upload. The dirty range is the union of the relative-write high-water mark
+     * (data().position()) and any ranges reported through {@link #markDirty(int, int)}; a write mapping
+     * with neither (written through its address, absolute puts or a slice) uploads its whole window.
+     * Buffers with a shadow copy fill the staging block from it, so untouched bytes of an uploaded
+     * window keep their contents, and mirror the uploaded range into it.
+     */
+    public final class StagingView implements MappedView {
+        private final int mapOffset;
+        private final int length;
+        private final ByteBuffer staging;
+        private final boolean write;
+        private int dirtyStart = Integer.MAX_VALUE;
+        private int dirtyEnd = 0;
+        private boolean unmapped = false;
+
+        private StagingView(int mapOffset, int length, boolean read, boolean write) {
+            this.mapOffset = mapOffset;
+            this.length = length;
+            this.write = write;
+            this.staging = BgfxUploadPool.acquire(length);
+            if ((read || write) && shadow != null) {
+                staging.put(0, shadow, mapOffset, length);
             }
+        }
 
-            @Override
-            public void close() {
-                if (!unmapped) {
-                    mappedBuffer.flip();
-                    updateData(0, mappedBuffer);
-                    unmapped = true;
-                }
+        @Override
+        public ByteBuffer data() {
+            return staging;
+        }
+
+        /**
+         * Record bytes written with absolute puts, relative to the start of the mapped window.
+         */
+        public void markDirty(int start, int length) {
+            dirtyStart = Math.min(dirtyStart, start);
+            dirtyEnd = Math.max(dirtyEnd, start + length);
+        }
+
+        @Override
+        public void close() {
+            if (unmapped) {
+                return;
+            }
+            unmapped = true;
+
+            if (!write) {
+                BgfxUploadPool.release(staging);
+                return;
+            }
+
+            // Relative writes cover [0, position); untracked writes may have touched any byte
+            if (staging.position() > 0) {
+                markDirty(0, staging.position());
+            } else if (dirtyStart >= dirtyEnd) {
+                markDirty(0, length);
+            }
+
+            // BGFX updates whole elements: clip the dirty range to element boundaries inside the
+            // mapped window (Minecraft writes whole vertices/indices, so nothing is lost in practice)
+            int element = elementSize();
+            int windowOffset = getBaseOffset() + mapOffset;
+            int first = (windowOffset + Math.max(dirtyStart, 0) + element - 1) / element;
+            int last = (windowOffset + Math.min(dirtyEnd, length)) / element;
+            int byteStart = Math.max(first * element - windowOffset, 0);
+            int byteEnd = Math.min(last * element - windowOffset, length);
+
+            if (byteStart >= byteEnd || bgfxHandle == BGFX.BGFX_INVALID_HANDLE) {
+                BgfxUploadPool.release(staging);
+                return;
+            }
+
+            if (shadow != null) {
+                shadow.put(mapOffset + byteStart, staging, byteStart, byteEnd - byteStart);
             }
-        };
+
+            boolean isVertexBuffer = type == BufferType.DYNAMIC_VERTEX_BUFFER || type == BufferType.VERTEX_BUFFER;
+            staging.limit(byteEnd).position(byteStart);
+            BgfxOperations.updateDynamicBuffer(bgfxHandle, first, BgfxUploadPool.submit(staging), isVertexBuffer);
+
+            LOGGER.trace("Unmapped {}: uploaded bytes [{}, {}) of {}-byte window at offset {}",
+                name, byteStart, byteEnd, length, mapOffset);
+        }
     }
 
     public void close() {
@@ -254,10 +453,21 @@ public class BgfxBuffer extends GpuBuffer {
             if (type == BufferType.UNIFORM_BUFFER) {
                 // CPU-side buffer, no BGFX resource to destroy
                 LOGGER.debug("Closing CPU-emulated uniform buffer: {}", name);
+            } else if (shared) {
+                // Owned and retired by BgfxSharedIndexBuffers
+                LOGGER.debug("Closing shared index buffer view: {}", name);
+            } else if (allocation != null) {
+                // Shared arena page: return the range, reusable once in-flight frames are done
+                LOGGER.debug("Releasing arena range of buffer: {} (handle: {}, offset: {})", name, bgfxHandle, allocation.getOffset());
+                BgfxBufferArena.free(allocation);
             } else if (bgfxHandle != 0 && bgfxHandle != BGFX.BGFX_INVALID_HANDLE) {
                 LOGGER.debug("Destroying buffer: {} (handle: {}, type: {})", name, bgfxHandle, type);
                 BgfxOperations.destroyResource(bgfxHandle, type.getResourceType());
             }
+            if (shadow != null) {
+                BgfxShadowStore.free(shadow);
+                shadow = null;
+            }
             closed = true;
         }
     }
@@ -0,0 +1,294 @@
+package com.vitra.render.bgfx;
+
+import org.lwjgl.bgfx.BGFX;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+import java.util.ArrayDeque;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.Map;
+import java.util.TreeMap;
+
+/**
+ * Sub-allocating arena that carves GpuDevice buffers out of a few large BGFX dynamic buffers.
+ *
+ * BGFX caps the number of dynamic buffer handles and every handle is a driver allocation, so
+ * VitraGpuDevice.createBuffer() allocates byte ranges from shared "mega buffer" pages instead:
+ * - small requests come from power-of-two size-class free lists
+ * - larger requests use a first-fit allocator per page that coalesces neighbouring free ranges
+ * - requests bigger than half a page get a dedicated BGFX buffer
+ *
+ * Vertex pages use the untyped BgfxVertexLayouts raw layout and their own backing store, so a range
+ * at byte offset B is bound with start vertex B / stride (plus a shifted layout for B % stride).
+ * Index pages hold 16-bit indices. Freed ranges are only reused once BGFX has consumed every frame
+ * that could reference them.
+ *
+ * Uses: bgfx_create_dynamic_vertex_buffer(), bgfx_create_dynamic_index_buffer()
+ */
+public final class BgfxBufferArena {
+    private static final Logger LOGGER = LoggerFactory.getLogger("BgfxBufferArena");
+
+    // Bytes per page; each page is a single BGFX dynamic buffer
+    private static final int PAGE_SIZE = 16 * 1024 * 1024;
+
+    // Allocation granularity in bytes; a multiple of every element size used by the pages
+    private static final int ALIGNMENT = 16;
+
+    // Size classes 256 B .. 64 KB are served from free lists
+    private static final int MIN_CLASS_SHIFT = 8;
+    private static final int MAX_CLASS_SHIFT = 16;
+
+    private static final Arena vertexArena = new Arena(true);
+    private static final Arena indexArena = new Arena(false);
+
+    /**
+     * A byte range of a BGFX dynamic buffer.
+     */
+    public static final class Allocation {
+        private final Arena arena;
+        private final Page page;
+        private final int offset;
+        private final int size;
+
+        private Allocation(Arena arena, Page page, int offset, int size) {
+            this.arena = arena;
+            this.page = page;
+            this.offset = offset;
+            this.size = size;
+        }
+
+        public short getHandle() {
+            return page.handle;
+        }
+
+        /**
+         * Byte offset of this allocation inside its BGFX buffer.
+         */
+        public int getOffset() {
+            return offset;
+        }
+
+        public int getSize() {
+            return size;
+        }
+    }
+
+    private static final class Page {
+        final short handle;
+        final boolean dedicated;
+        // Free ranges: offset -> size, kept coalesced
+        final TreeMap<Integer, Integer> freeRanges = new TreeMap<>();
+
+        Page(short handle, int size, boolean dedicated) {
+            this.handle = handle;
+            this.dedicated = dedicated;
+            freeRanges.put(0, size);
+        }
+
+        int allocate(int size) {
+            for (Map.Entry<Integer, Integer> range : freeRanges.entrySet()) {
+                int offset = range.getKey();
+                int available = range.getValue();
+                if (available >= size) {
+                    freeRanges.remove(offset);
+                    if (available > size) {
+                        freeRanges.put(offset + size, available - size);
+                    }
+                    return offset;
+                }
+            }
+            return -1;
+        }
+
+        void free(int offset, int size) {
+            Map.Entry<Integer, Integer> prev = freeRanges.floorEntry(offset);
+            if (prev != null && prev.getKey() + prev.getValue() == offset) {
+                offset = prev.getKey();
+                size += prev.getValue();
+                freeRanges.remove(offset);
+            }
+            Integer nextSize = freeRanges.get(offset + size);
+            if (nextSize != null) {
+                freeRanges.remove(offset + size);
+                size += nextSize;
+            }
+            freeRanges.put(offset, size);
+        }
+    }
+
+    private record PendingFree(Allocation allocation, long frame) {
+    }
+
+    private static final class Arena {
+        final boolean vertex;
+        final List<Page> pages = new ArrayList<>();
+        @SuppressWarnings("unchecked")
+        final ArrayDeque<Allocation>[] sizeClasses = new ArrayDeque[MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1];
+        final ArrayDeque<PendingFree> pendingFrees = new ArrayDeque<>();
+        long allocatedBytes;
+
+        Arena(boolean vertex) {
+            this.vertex = vertex;
+            for (int i = 0; i < sizeClasses.length; i++) {
+                sizeClasses[i] = new ArrayDeque<>();
+            }
+        }
+
+        Allocation allocate(int size) {
+            int aligned = Math.max(ALIGNMENT, (size + ALIGNMENT - 1) & -ALIGNMENT);
+
+            int sizeClass = sizeClass(aligned);
+            if (sizeClass >= 0) {
+                Allocation block = sizeClasses[sizeClass].poll();
+                return block != null ? track(block) : allocateRange(1 << (sizeClass + MIN_CLASS_SHIFT));
+            }
+
+            if (aligned > PAGE_SIZE / 2) {
+                Page page = createPage(aligned, true);
+                return page != null ? track(new Allocation(this, page, 0, aligned)) : null;
+            }
+            return allocateRange(aligned);
+        }
+
+        Allocation allocateRange(int size) {
+            for (Page page : pages) {
+                if (!page.dedicated) {
+                    int offset = page.allocate(size);
+                    if (offset >= 0) {
+                        return track(new Allocation(this, page, offset, size));
+                    }
+                }
+            }
+
+            Page page = createPage(PAGE_SIZE, false);
+            if (page == null) {
+                return null;
+            }
+            return track(new Allocation(this, page, page.allocate(size), size));
+        }
+
+        Allocation track(Allocation allocation) {
+            allocatedBytes += allocation.size;
+            return allocation;
+        }
+
+        Page createPage(int size, boolean dedicated) {
+            short handle;
+            if (vertex) {
+                // Own backing store (COMPUTE_READ) so the page starts at BGFX vertex 0
+                handle = BgfxOperations.createDynamicVertexBuffer(size / BgfxVertexLayouts.RAW_STRIDE,
+                    BgfxVertexLayouts.getRawLayout(), BGFX.BGFX_BUFFER_COMPUTE_READ);
+            } else {
+                handle = BgfxOperations.createDynamicIndexBuffer(size / 2, BGFX.BGFX_BUFFER_NONE);
+            }
+
+            if (!Util.isValidHandle(handle)) {
+                LOGGER.error("Failed to create {} {} page ({} bytes)", dedicated ? "dedicated" : "shared", kind(), size);
+                return null;
+            }
+
+            BgfxBufferLifetime.track(handle, type());
+            Page page = new Page(handle, size, dedicated);
+            pages.add(page);
+            LOGGER.debug("Created {} {} page: handle={}, size={}", dedicated ? "dedicated" : "shared", kind(), handle, size);
+            return page;
+        }
+
+        void reclaim(Allocation allocation) {
+            allocatedBytes -= allocation.size;
+
+            if (allocation.page.dedicated) {
+                pages.remove(allocation.page);
+                BgfxBufferLifetime.retire(allocation.page.handle, type());
+                return;
+            }
+
+            int sizeClass = sizeClass(allocation.size);
+            if (sizeClass >= 0 && allocation.size == 1 << (sizeClass + MIN_CLASS_SHIFT)) {
+                // Size-class blocks are kept for reuse rather than coalesced back
+                sizeClasses[sizeClass].add(allocation);
+            } else {
+                allocation.page.free(allocation.offset, allocation.size);
+            }
+        }
+
+        int type() {
+            return vertex ? Util.RESOURCE_DYNAMIC_VERTEX_BUFFER : Util.RESOURCE_DYNAMIC_INDEX_BUFFER;
+        }
+
+        String kind() {
+            return vertex ? "vertex" : "index";
+        }
+    }
+
+    private static int sizeClass(int size) {
+        int shift = Math.max(MIN_CLASS_SHIFT, 32 - Integer.numberOfLeadingZeros(size - 1));
+        return shift <= MAX_CLASS_SHIFT ? shift - MIN_CLASS_SHIFT : -1;
+    }
+
+    /**
+     * Allocate a byte range for a vertex buffer, or null if BGFX could not create a page.
+     */
+    public static synchronized Allocation allocateVertex(int size) {
+        return vertexArena.allocate(size);
+    }
+
+    /**
+     * Allocate a byte range for a 16-bit index buffer, or null if BGFX could not create a page.
+     */
+    public static synchronized Allocation allocateIndex(int size) {
+        return indexArena.allocate(size);
+    }
+
+    /**
+     * Return a range to the arena. It becomes reusable once BGFX has consumed the current frame.
+     */
+    public static synchronized void free(Allocation allocation) {
+        allocation.arena.pendingFrees.add(new PendingFree(allocation, BgfxFence.getCurrentFrame()));
+    }
+
+    /**
+     * Reclaim ranges freed at least FRAME_LATENCY frames ago.
+     * Called on the render thread after bgfx_frame() and BgfxFence.advanceFrame().
+     */
+    public static synchronized void endFrame() {
+        long currentFrame = BgfxFence.getCurrentFrame();
+        for (Arena arena : new Arena[] {vertexArena, indexArena}) {
+            while (!arena.pendingFrees.isEmpty()
+                && arena.pendingFrees.peek().frame() + BgfxBufferLifetime.FRAME_LATENCY <= currentFrame) {
+                arena.reclaim(arena.pendingFrees.poll().allocation());
+            }
+        }
+    }
+
+    /**
+     * Summary of page counts and bytes in use, for logs and debug overlays.
+     */
+    public static synchronized String getStats() {
+        return String.format("vertex pages=%d live=%d KB | index pages=%d live=%d KB",
+            vertexArena.pages.size(), vertexArena.allocatedBytes / 1024,
+            indexArena.pages.size(), indexArena.allocatedBytes / 1024);
+    }
+
+    /**
+     * Retire all pages. Called on renderer shutdown, before BgfxBufferLifetime.flush().
+     */
+    public static synchronized void shutdown() {
+        for (Arena arena : new Arena[] {vertexArena, indexArena}) {
+            for (Page page : arena.pages) {
+                BgfxBufferLifetime.retire(page.handle, arena.type());
+            }
+            arena.pages.clear();
+            arena.pendingFrees.clear();
+            for (ArrayDeque<Allocation> sizeClass : arena.sizeClasses) {
+                sizeClass.clear();
+            }
+            arena.allocatedBytes = 0;
+        }
+        LOGGER.info("Buffer arena shutdown complete");
+    }
+
+    private BgfxBufferArena() {
+    }
+}
@@ -9,35 +9,28 @@ import java.util.Map;
 import java.util.concurrent.ConcurrentHashMap;
 
 /**
- * Central cache for BGFX buffer handles created from Minecraft's BufferBuilder/MeshData.
+ * Central cache connecting Minecraft's BufferBuilder/MeshData to the frame geometry packed for them.
  *
  * This is NOT a mixin, so it can provide public static access without violating Mixin framework rules.
  * BufferBuilderMixin populates these caches, and MultiBufferSourceMixin reads from them.
+ *
+ * The cache owns no BGFX handles: ranges belong to BgfxFrameGeometry, whose pooled slots, arena pages
+ * and shared index buffers are retired through BgfxBufferLifetime by their owners.
  */
 public class BgfxBufferCache {
     private static final Logger LOGGER = LoggerFactory.getLogger(BgfxBufferCache.class);
 
-    // Cache: MeshData hash -> BGFX vertex buffer handle
-    private static final Map<Integer, Short> vertexBufferCache = new ConcurrentHashMap<>();
-
-    // Cache: MeshData hash -> BGFX index buffer handle
-    private static final Map<Integer, Short> indexBufferCache = new ConcurrentHashMap<>();
-
     // Cache: BufferBuilder hash -> MeshData (to connect BufferBuilder to MeshData in endBatch)
     private static final Map<Integer, MeshData> bufferBuilderToMeshData = new ConcurrentHashMap<>();
 
-    /**
-     * Get cached vertex buffer handle for MeshData.
-     */
-    public static short getVertexBufferHandle(MeshData meshData) {
-        return vertexBufferCache.getOrDefault(System.identityHashCode(meshData), (short) -1);
-    }
+    // Cache: MeshData hash -> frame-scoped geometry range (cleared every frame)
+    private static final Map<Integer, BgfxFrameGeometry.Range> geometryCache = new ConcurrentHashMap<>();
 
     /**
-     * Get cached index buffer handle for MeshData.
+     * Get the frame-scoped geometry range for MeshData, or null if none was packed this frame.
      */
-    public static short getIndexBufferHandle(MeshData meshData) {
-        return indexBufferCache.getOrDefault(System.identityHashCode(meshData), (short) -1);
+    public static BgfxFrameGeometry.Range getGeometry(MeshData meshData) {
+        return geometryCache.get(System.identityHashCode(meshData));
     }
 
     /**
@@ -49,19 +42,30 @@ public class BgfxBufferCache {
     }
 
     /**
-     * Store vertex buffer handle for MeshData.
-     * Called by BufferBuilderMixin when creating BGFX buffers.
+     * Store frame-scoped geometry range for MeshData.
+     * Called by BufferBuilderMixin after packing geometry into BgfxFrameGeometry.
      */
-    public static void putVertexBufferHandle(MeshData meshData, short handle) {
-        vertexBufferCache.put(System.identityHashCode(meshData), handle);
+    public static void putGeometry(MeshData meshData, BgfxFrameGeometry.Range range) {
+        geometryCache.put(System.identityHashCode(meshData), range);
     }
 
     /**
-     * Store index buffer handle for MeshData.
-     * Called by BufferBuilderMixin when creating BGFX buffers.
+     * Forget the range of a MeshData that Minecraft has closed, so a later MeshData with the same
+     * identity hash in this frame does not pick it up.
+     * Called by MeshDataMixin; safe to call from any thread.
      */
-    public static void putIndexBufferHandle(MeshData meshData, short handle) {
-        indexBufferCache.put(System.identityHashCode(meshData), handle);
+    public static void onMeshDataClosed(MeshData meshData) {
+        // The range itself stays valid until BgfxFrameGeometry.endFrame() recycles it
+        geometryCache.remove(System.identityHashCode(meshData));
+    }
+
+    /**
+     * Drop all frame-scoped geometry ranges.
+     * Called after bgfx_frame(), together with BgfxFrameGeometry.endFrame().
+     */
+    public static void endFrame() {
+        geometryCache.clear();
+        bufferBuilderToMeshData.clear();
     }
 
     /**
@@ -73,33 +77,17 @@ public class BgfxBufferCache {
     }
 
     /**
-     * Cleanup cached buffer handles.
-     * Call this when shutting down or when buffers are no longer needed.
+     * Clear the caches and destroy every buffer handle still waiting in BgfxBufferLifetime.
+     * Called on renderer shutdown, after the buffer owners have retired their handles.
      */
     public static void cleanup() {
-        LOGGER.info("Cleaning up {} cached vertex buffers and {} index buffers",
-            vertexBufferCache.size(), indexBufferCache.size());
-
-        // Destroy all cached vertex buffers
-        vertexBufferCache.values().forEach(handle -> {
-            if (Util.isValidHandle(handle)) {
-                Util.destroy(handle, Util.RESOURCE_VERTEX_BUFFER);
-            }
-        });
-        vertexBufferCache.clear();
-
-        // Destroy all cached index buffers
-        indexBufferCache.values().forEach(handle -> {
-            if (Util.isValidHandle(handle)) {
-                Util.destroy(handle, Util.RESOURCE_INDEX_BUFFER);
-            }
-        });
-        indexBufferCache.clear();
+        BgfxBufferLifetime.flush();
 
-        // Clear BufferBuilder -> MeshData associations
+        // Clear BufferBuilder -> MeshData associations and frame geometry
         bufferBuilderToMeshData.clear();
+        geometryCache.clear();
 
-        LOGGER.info("BufferBuilder cache cleanup complete");
+        LOGGER.info("BufferBuilder cache cleanup complete ({})", BgfxBufferLifetime.getStats());
     }
 
     private BgfxBufferCache() {
@@ -0,0 +1,144 @@
+package com.vitra.render.bgfx;
+
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+import java.util.ArrayDeque;
+import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.concurrent.atomic.AtomicLongArray;
+
+/**
+ * Frame-fenced deferred destruction for BGFX buffer handles.
+ *
+ * BGFX renders frame N on its render thread while the API thread records frame N+1,
+ * so a handle referenced by frame N must survive until BGFX has consumed that frame.
+ * Retired handles are tagged with the current {@link BgfxFence} frame number and only
+ * destroyed once the frame counter has moved past that frame plus the pipeline latency.
+ *
+ * Live, pending and freed counts are tracked per buffer type (Util.RESOURCE_* constants)
+ * for monitoring.
+ */
+public final class BgfxBufferLifetime {
+    private static final Logger LOGGER = LoggerFactory.getLogger("BgfxBufferLifetime");
+
+    // bgfx_frame() N returns once frame N-1 is rendered, so frame N is consumed after frame N+1 is submitted
+    static final long FRAME_LATENCY = 2;
+
+    // Buffer types tracked: RESOURCE_VERTEX_BUFFER .. RESOURCE_DYNAMIC_INDEX_BUFFER
+    private static final int TYPE_COUNT = Util.RESOURCE_DYNAMIC_INDEX_BUFFER + 1;
+
+    private static final AtomicLongArray liveCounts = new AtomicLongArray(TYPE_COUNT);
+    private static final AtomicLongArray pendingCounts = new AtomicLongArray(TYPE_COUNT);
+    private static final AtomicLongArray freedCounts = new AtomicLongArray(TYPE_COUNT);
+
+    // Retired handles may come from any thread; destruction happens on the render thread
+    private static final ConcurrentLinkedQueue<Retired> retiredQueue = new ConcurrentLinkedQueue<>();
+    private static final ArrayDeque<Retired> pending = new ArrayDeque<>();
+
+    private record Retired(short handle, int type, long frame) {
+    }
+
+    /**
+     * Record a newly created buffer handle as live.
+     */
+    public static void track(short handle, int type) {
+        if (Util.isValidHandle(handle) && isBufferType(type)) {
+            liveCounts.incrementAndGet(type);
+        }
+    }
+
+    /**
+     * Queue a live buffer handle for destruction once BGFX has consumed the current frame.
+     * Safe to call from any thread.
+     */
+    public static void retire(short handle, int type) {
+        if (!Util.isValidHandle(handle) || !isBufferType(type)) {
+            return;
+        }
+
+        liveCounts.decrementAndGet(type);
+        pendingCounts.incrementAndGet(type);
+        retiredQueue.add(new Retired(handle, type, BgfxFence.getCurrentFrame()));
+        LOGGER.trace("Retired buffer handle {} (type {}) at frame {}", handle, type, BgfxFence.getCurrentFrame());
+    }
+
+    /**
+     * Destroy every retired handle whose frame has been consumed by BGFX.
+     * Called on the render thread after bgfx_frame() and BgfxFence.advanceFrame().
+     */
+    public static void processRetired() {
+        Retired retired;
+        while ((retired = retiredQueue.poll()) != null) {
+            pending.add(retired);
+        }
+
+        long currentFrame = BgfxFence.getCurrentFrame();
+        int destroyed = 0;
+
+        // Entries are queued in frame order, so stop at the first one still in flight
+        while (!pending.isEmpty() && pending.peek().frame() + FRAME_LATENCY <= currentFrame) {
+            destroy(pending.poll());
+            destroyed++;
+        }
+
+        if (destroyed > 0) {
+            LOGGER.trace("Destroyed {} retired buffer handles at frame {}", destroyed, currentFrame);
+        }
+    }
+
+    /**
+     * Destroy every retired handle immediately. Only valid during shutdown,
+     * when no further frames will reference them.
+     */
+    public static void flush() {
+        Retired retired;
+        while ((retired = retiredQueue.poll()) != null) {
+            pending.add(retired);
+        }
+        while (!pending.isEmpty()) {
+            destroy(pending.poll());
+        }
+    }
+
+    private static void destroy(Retired retired) {
+        Util.destroy(retired.handle(), retired.type());
+        pendingCounts.decrementAndGet(retired.type());
+        freedCounts.incrementAndGet(retired.type());
+    }
+
+    private static boolean isBufferType(int type) {
+        return type >= 0 && type < TYPE_COUNT;
+    }
+
+    public static long getLiveCount(int type) {
+        return liveCounts.get(type);
+    }
+
+    public static long getPendingCount(int type) {
+        return pendingCounts.get(type);
+    }
+
+    public static long getFreedCount(int type) {
+        return freedCounts.get(type);
+    }
+
+    /**
+     * Summary of live/pending/freed counts per buffer type, for logs and debug overlays.
+     */
+    public static String getStats() {
+        return String.format(
+            "VB live=%d pending=%d freed=%d | IB live=%d pending=%d freed=%d | " +
+            "DVB live=%d pending=%d freed=%d | DIB live=%d pending=%d freed=%d",
+            liveCounts.get(Util.RESOURCE_VERTEX_BUFFER), pendingCounts.get(Util.RESOURCE_VERTEX_BUFFER),
+            freedCounts.get(Util.RESOURCE_VERTEX_BUFFER),
+            liveCounts.get(Util.RESOURCE_INDEX_BUFFER), pendingCounts.get(Util.RESOURCE_INDEX_BUFFER),
+            freedCounts.get(Util.RESOURCE_INDEX_BUFFER),
+            liveCounts.get(Util.RESOURCE_DYNAMIC_VERTEX_BUFFER), pendingCounts.get(Util.RESOURCE_DYNAMIC_VERTEX_BUFFER),
+            freedCounts.get(Util.RESOURCE_DYNAMIC_VERTEX_BUFFER),
+            liveCounts.get(Util.RESOURCE_DYNAMIC_INDEX_BUFFER), pendingCounts.get(Util.RESOURCE_DYNAMIC_INDEX_BUFFER),
+            freedCounts.get(Util.RESOURCE_DYNAMIC_INDEX_BUFFER));
+    }
+
+    private BgfxBufferLifetime() {
+    }
+}
@@ -26,6 +26,8 @@ public class BgfxCommandEncoder implements CommandEncoder {
     private static final Logger LOGGER = LoggerFactory.getLogger("BgfxCommandEncoder");
 
     private boolean closed = false;
+    // Most recently created render pass; target of setScissor()
+    private VitraRenderPass lastPass = null;
 
     public BgfxCommandEncoder() {
         LOGGER.debug("Created BGFX command encoder");
@@ -51,7 +53,8 @@ public class BgfxCommandEncoder implements CommandEncoder {
         GpuTextureView colorAttachment,
         OptionalInt clearColor
     ) {
-        return new VitraRenderPass(name, colorAttachment, clearColor, null, OptionalDouble.empty());
+        lastPass = new VitraRenderPass(name, colorAttachment, clearColor, null, OptionalDouble.empty());
+        return lastPass;
     }
 
     @Override
@@ -62,7 +65,8 @@ public class BgfxCommandEncoder implements CommandEncoder {
         GpuTextureView depthAttachment,
         OptionalDouble clearDepth
     ) {
-        return new VitraRenderPass(name, colorAttachment, clearColor, depthAttachment, clearDepth);
+        lastPass = new VitraRenderPass(name, colorAttachment, clearColor, depthAttachment, clearDepth);
+        return lastPass;
     }
 
     // ========== Texture Clearing ==========
@@ -79,27 +83,9 @@ public class BgfxCommandEncoder implements CommandEncoder {
             return;
         }
 
-        try {
-            int width = bgfxTexture.getWidth(0);
-            int height = bgfxTexture.getHeight(0);
-            ByteBuffer clearData = ByteBuffer.allocateDirect(width * height * 4);
-
-            // Fill with color (RGBA format)
-            int r = (color >> 24) & 0xFF;
-            int g = (color >> 16) & 0xFF;
-            int b = (color >> 8) & 0xFF;
-            int a = color & 0xFF;
-
-            for (int i = 0; i < width * height; i++) {
-                clearData.put((byte)r).put((byte)g).put((byte)b).put((byte)a);
-            }
-            clearData.flip();
-
-            bgfxTexture.updateData(0, 0, 0, width, height, clearData);
-            LOGGER.debug("Color texture cleared: {}", bgfxTexture.getTextureName());
-        } catch (Exception e) {
-            LOGGER.error("Failed to clear color texture", e);
-        }
+        // View clear on the texture's framebuffer (no CPU fill, no upload)
+        BgfxViews.clear(bgfxTexture, null, OptionalInt.of(color), OptionalDouble.empty(), 0, 0, -1, -1);
+        LOGGER.debug("Color texture cleared: {}", bgfxTexture.getTextureName());
     }
 
     @Override
@@ -109,8 +95,7 @@ public class BgfxCommandEncoder implements CommandEncoder {
         GpuTexture depthTexture,
         double depth
     ) {
-        clearColorTexture(colorTexture, color);
-        clearDepthTexture(depthTexture, depth);
+        clearColorAndDepthTextures(colorTexture, color, depthTexture, depth, 0, 0, -1, -1);
     }
 
     @Override
@@ -121,28 +106,19 @@ public class BgfxCommandEncoder implements CommandEncoder {
         double depth,
         int x, int y, int width, int height
     ) {
-        // Clear specific region
-        if (!(colorTexture instanceof BgfxTexture bgfxColor)) {
-            LOGGER.error("Color texture must be BgfxTexture instance");
+        if (closed) {
+            LOGGER.error("Cannot use closed command encoder");
             return;
         }
 
-        try {
-            ByteBuffer clearData = ByteBuffer.allocateDirect(width * height * 4);
-            int r = (color >> 24) & 0xFF;
-            int g = (color >> 16) & 0xFF;
-            int b = (color >> 8) & 0xFF;
-            int a = color & 0xFF;
-
-            for (int i = 0; i < width * height; i++) {
-                clearData.put((byte)r).put((byte)g).put((byte)b).put((byte)a);
-            }
-            clearData.flip();
-
-            bgfxColor.updateData(0, x, y, width, height, clearData);
-        } catch (Exception e) {
-            LOGGER.error("Failed to clear color and depth textures", e);
+        if (!(colorTexture instanceof BgfxTexture bgfxColor) || !(depthTexture instanceof BgfxTexture bgfxDepth)) {
+            LOGGER.error("Color and depth textures must be BgfxTexture instances");
+            return;
         }
+
+        // One view clears both attachments; a partial rect is cleared by BGFX's scissored clear quad
+        BgfxViews.clear(bgfxColor, bgfxDepth, OptionalInt.of(color), OptionalDouble.of(depth), x, y, width, height);
+        LOGGER.debug("Color and depth textures cleared: {} / {}", bgfxColor.getTextureName(), bgfxDepth.getTextureName());
     }
 
     @Override
@@ -157,23 +133,8 @@ public class BgfxCommandEncoder implements CommandEncoder {
             return;
         }
 
-        try {
-            int width = bgfxTexture.getWidth(0);
-            int height = bgfxTexture.getHeight(0);
-            ByteBuffer clearData = ByteBuffer.allocateDirect(width * height * 4);
-
-            // Fill with depth value (D24S8 format - 24 bits depth, 8 bits stencil)
-            int depthInt = (int)(depth * 0xFFFFFF);
-            for (int i = 0; i < width * height; i++) {
-                clearData.putInt(depthInt);
-            }
-            clearData.flip();
-
-            bgfxTexture.updateData(0, 0, 0, width, height, clearData);
-            LOGGER.debug("Depth texture cleared: {}", bgfxTexture.getTextureName());
-        } catch (Exception e) {
-            LOGGER.error("Failed to clear depth texture", e);
-        }
+        BgfxViews.clear(null, bgfxTexture, OptionalInt.empty(), OptionalDouble.of(depth), 0, 0, -1, -1);
+        LOGGER.debug("Depth texture cleared: {}", bgfxTexture.getTextureName());
     }
 
     // ========== Buffer Operations ==========
@@ -231,7 +192,23 @@ public class BgfxCommandEncoder implements CommandEncoder {
             LOGGER.error("Buffer slice is null");
             return null;
         }
-        return mapBuffer(slice.buffer(), read, write);
+        if (closed) {
+            LOGGER.error("Cannot use closed command encoder");
+            return null;
+        }
+
+        if (!(slice.buffer() instanceof BgfxBuffer bgfxBuffer)) {
+            LOGGER.error("Buffer must be BgfxBuffer instance");
+            return null;
+        }
+
+        // Map only the slice so unmap uploads just this range at its offset
+        try {
+            return bgfxBuffer.map((int) slice.offset(), (int) slice.length(), read, write);
+        } catch (Exception e) {
+            LOGGER.error("Failed to map buffer slice", e);
+            return null;
+        }
     }
 
     @Override
@@ -255,14 +232,17 @@ public class BgfxCommandEncoder implements CommandEncoder {
         }
 
         try {
-            long size = Math.min(src.length(), dst.length());
-            ByteBuffer tempData = ByteBuffer.allocateDirect((int)size);
-
-            // BGFX doesn't have direct buffer-to-buffer copy
-            // Read from source and write to destination
-            // TODO: Implement actual read from BgfxBuffer
+            int size = (int) Math.min(src.length(), dst.length());
+
+            // BGFX has no buffer-to-buffer copy or readback: serve the copy from the source's CPU shadow
+            ByteBuffer srcData = bgfxSrc.readShadow((int) src.offset(), size);
+            if (srcData == null) {
+                LOGGER.warn("Skipping buffer copy {} -> {}: source has no CPU shadow (needs USAGE_COPY_SRC)",
+                    bgfxSrc.getName(), bgfxDst.getName());
+                return;
+            }
 
-            bgfxDst.updateData((int)dst.offset(), tempData);
+            bgfxDst.updateData((int)dst.offset(), srcData);
             LOGGER.debug("Buffer copy completed: {} -> {} ({} bytes)",
                 bgfxSrc.getName(), bgfxDst.getName(), size);
         } catch (Exception e) {
@@ -285,22 +265,13 @@ public class BgfxCommandEncoder implements CommandEncoder {
         }
 
         try {
-            LOGGER.info("[TEXTURE UPLOAD] Starting: {} ({}x{}) on thread: {}",
+            LOGGER.debug("[TEXTURE UPLOAD] Starting: {} ({}x{}) on thread: {}",
                 bgfxTexture.getTextureName(), image.getWidth(), image.getHeight(),
                 Thread.currentThread().getName());
 
-            // NativeImage.pixels is private, use makePixelArray() instead
-            LOGGER.info("[TEXTURE UPLOAD] Converting pixel data for: {}", bgfxTexture.getTextureName());
-            int[] pixels = image.makePixelArray();
-            ByteBuffer imageData = ByteBuffer.allocateDirect(pixels.length * 4);
-            for (int pixel : pixels) {
-                imageData.putInt(pixel);
-            }
-            imageData.flip();
-
-            LOGGER.info("[TEXTURE UPLOAD] Calling updateData for: {}", bgfxTexture.getTextureName());
-            bgfxTexture.updateData(0, 0, 0, image.getWidth(), image.getHeight(), imageData);
-            LOGGER.info("[TEXTURE UPLOAD] Completed: {}", bgfxTexture.getTextureName());
+            // Straight from the image's native pixels
+            bgfxTexture.updateData(0, 0, 0, image.getWidth(), image.getHeight(), image, 0, 0);
+            LOGGER.debug("[TEXTURE UPLOAD] Completed: {}", bgfxTexture.getTextureName());
         } catch (Exception e) {
             LOGGER.error("[TEXTURE UPLOAD] Failed for: {}", bgfxTexture.getTextureName(), e);
         }
@@ -310,8 +281,8 @@ public class BgfxCommandEncoder implements CommandEncoder {
     public void writeToTexture(
         GpuTexture texture,
         NativeImage image,
-        int mipLevel, int x, int y,
-        int width, int height, int srcX, int srcY, int depth
+        int mipLevel, int depth, int x, int y,
+        int width, int height, int srcX, int srcY
     ) {
         if (closed) {
             LOGGER.error("Cannot use closed command encoder");
@@ -324,24 +295,8 @@ public class BgfxCommandEncoder implements CommandEncoder {
         }
 
         try {
-            // Extract sub-region from image using pixel array
-            int[] pixels = image.makePixelArray();
-            int srcWidth = image.getWidth();
-
-            ByteBuffer subRegion = ByteBuffer.allocateDirect(width * height * 4);
-            for (int row = 0; row < height; row++) {
-                for (int col = 0; col < width; col++) {
-                    int srcIdx = (srcY + row) * srcWidth + (srcX + col);
-                    if (srcIdx >= 0 && srcIdx < pixels.length) {
-                        subRegion.putInt(pixels[srcIdx]);
-                    } else {
-                        subRegion.putInt(0); // Black pixel for out of bounds
-                    }
-                }
-            }
-            subRegion.flip();
-
-            bgfxTexture.updateData(mipLevel, x, y, width, height, subRegion);
+            // Region read in place from the image's native pixels (srcX/srcY skip into its rows)
+            bgfxTexture.updateData(mipLevel, x, y, width, height, image, srcX, srcY);
             LOGGER.debug("Texture sub-region write completed: {} (mip {})",
                 bgfxTexture.getTextureName(), mipLevel);
         } catch (Exception e) {
@@ -354,7 +309,7 @@ public class BgfxCommandEncoder implements CommandEncoder {
         GpuTexture texture,
         IntBuffer data,
         NativeImage.Format format,
-        int mipLevel, int x, int y, int width, int height, int depth
+        int mipLevel, int depth, int x, int y, int width, int height
     ) {
         if (closed) {
             LOGGER.error("Cannot use closed command encoder");
@@ -368,13 +323,10 @@ public class BgfxCommandEncoder implements CommandEncoder {
 
         try {
             // Convert IntBuffer to ByteBuffer
-            ByteBuffer byteData = ByteBuffer.allocateDirect(data.remaining() * 4);
-            while (data.hasRemaining()) {
-                byteData.putInt(data.get());
-            }
-            byteData.flip();
+            ByteBuffer byteData = BgfxUploadPool.acquire(data.remaining() * 4);
+            byteData.asIntBuffer().put(data);
 
-            bgfxTexture.updateData(mipLevel, x, y, width, height, byteData);
+            bgfxTexture.updateData(mipLevel, x, y, width, height, BgfxUploadPool.submit(byteData));
             LOGGER.debug("Texture write from IntBuffer completed: {} (mip {})",
                 bgfxTexture.getTextureName(), mipLevel);
         } catch (Exception e) {
@@ -393,13 +345,17 @@ public class BgfxCommandEncoder implements CommandEncoder {
             return;
         }
 
-        // BGFX doesn't have direct buffer-to-buffer copy, so we need to read and write
+        // BGFX doesn't have direct buffer-to-buffer copy: write the source's CPU shadow into the destination
         try {
-            ByteBuffer tempData = ByteBuffer.allocateDirect((int) size);
+            ByteBuffer srcData = bgfxSrc.readShadow((int) srcOffset, (int) size);
+            if (srcData == null) {
+                LOGGER.warn("Skipping buffer copy {} -> {}: source has no CPU shadow (needs USAGE_COPY_SRC)",
+                    bgfxSrc.getName(), bgfxDst.getName());
+                return;
+            }
 
-            // For BGFX, we would typically update the destination buffer directly
-            // This is a simplified implementation
-            LOGGER.debug("Buffer copy requested: src={}, dst={}, size={}",
+            bgfxDst.updateData((int) dstOffset, srcData);
+            LOGGER.debug("Buffer copy completed: src={}, dst={}, size={}",
                 bgfxSrc.getName(), bgfxDst.getName(), size);
 
         } catch (Exception e) {
@@ -506,10 +462,13 @@ public class BgfxCommandEncoder implements CommandEncoder {
         }
 
         try {
-            // For simplicity, we'll assume the buffer contains the texture data
-            // In a real implementation, you'd need to handle the buffer format correctly
-            ByteBuffer bufferData = ByteBuffer.allocateDirect((int) size);
-            // TODO: Extract data from bgfxSrc into bufferData
+            // The buffer holds tightly packed rows in the texture's format; read them from its CPU shadow
+            ByteBuffer bufferData = bgfxSrc.readShadow((int) offset, (int) size);
+            if (bufferData == null) {
+                LOGGER.warn("Skipping buffer to texture copy {} -> {}: source has no CPU shadow (needs USAGE_COPY_SRC)",
+                    bgfxSrc.getName(), bgfxDst.getTextureName());
+                return;
+            }
 
             if (bgfxDst.updateData(mipLevel, x, y, width, height, bufferData)) {
                 LOGGER.debug("Buffer to texture copy completed: {} -> {}",
@@ -533,8 +492,9 @@ public class BgfxCommandEncoder implements CommandEncoder {
             return;
         }
 
-        // BGFX handles mipmap generation automatically when textures are created with mips
-        LOGGER.debug("Mipmap generation requested for: {} (handled automatically by BGFX)",
+        // BGFX does not build mips of updated textures; BgfxMipmaps rebuilds them from level 0 writes at
+        // the end of every frame, covering only the texels written since the last rebuild
+        LOGGER.debug("Mipmap generation requested for: {} (rebuilt from level 0 at end of frame)",
             bgfxTexture.getTextureName());
     }
 
@@ -544,7 +504,12 @@ public class BgfxCommandEncoder implements CommandEncoder {
             return;
         }
 
-        BgfxOperations.setScissorRect(x, y, width, height);
+        // Clips the following draws of the most recently opened render pass, not the whole view
+        if (lastPass == null) {
+            LOGGER.warn("Scissor rect {},{},{}x{} set without a render pass, ignoring", x, y, width, height);
+            return;
+        }
+        lastPass.enableScissor(x, y, width, height);
         LOGGER.debug("Scissor rect set: {},{},{}x{}", x, y, width, height);
     }
 
@@ -559,20 +524,19 @@ public class BgfxCommandEncoder implements CommandEncoder {
             return;
         }
 
-        // Create a clear buffer and update the texture region
-        try {
-            ByteBuffer clearData = ByteBuffer.allocateDirect(width * height * 4); // Assuming RGBA8
-            clearData.clear(); // Zeroes the buffer
+        // Framebuffers are built on mip 0
+        if (mipLevel != 0) {
+            LOGGER.warn("Cannot clear mip {} of {}, only mip 0 can be cleared", mipLevel, bgfxTexture.getTextureName());
+            return;
+        }
 
-            if (bgfxTexture.updateData(mipLevel, x, y, width, height, clearData)) {
-                LOGGER.debug("Texture region cleared: {} ({}x{} at {},{})",
-                    bgfxTexture.getTextureName(), width, height, x, y);
-            } else {
-                LOGGER.error("Failed to clear texture region");
-            }
-        } catch (Exception e) {
-            LOGGER.error("Failed to clear texture", e);
+        // Zero the region: transparent black for color textures, depth 0 for depth textures
+        if (bgfxTexture.isDepthFormat()) {
+            BgfxViews.clear(null, bgfxTexture, OptionalInt.empty(), OptionalDouble.of(0.0), x, y, width, height);
+        } else {
+            BgfxViews.clear(bgfxTexture, null, OptionalInt.of(0), OptionalDouble.empty(), x, y, width, height);
         }
+        LOGGER.debug("Texture region cleared: {} ({}x{} at {},{})", bgfxTexture.getTextureName(), width, height, x, y);
     }
 
     public void end() {
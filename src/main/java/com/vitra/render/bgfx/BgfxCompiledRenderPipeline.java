@@ -1,24 +1,42 @@
 package com.vitra.render.bgfx;
 
+import com.mojang.blaze3d.pipeline.BlendFunction;
 import com.mojang.blaze3d.pipeline.CompiledRenderPipeline;
 import com.mojang.blaze3d.pipeline.RenderPipeline;
+import com.mojang.blaze3d.platform.PolygonMode;
 import com.mojang.blaze3d.shaders.ShaderType;
+import com.mojang.blaze3d.vertex.VertexFormat;
 import net.minecraft.resources.ResourceLocation;
+import org.lwjgl.bgfx.BGFX;
 import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 
+import java.util.List;
 import java.util.function.BiFunction;
 
 /**
  * Simplified BGFX compiled render pipeline implementation using BGFX native functionality directly
  * Replaces the complex VitraCompiledRenderPipeline wrapper class
+ *
+ * Everything a render pass needs per draw is derived once here: the 64-bit BGFX state word (blend,
+ * depth test and write, cull, color mask, primitive topology), the vertex format and the sort mode.
+ * Switching pipelines is then a field read, with no per-draw state building.
  */
 public class BgfxCompiledRenderPipeline implements CompiledRenderPipeline {
     private static final Logger LOGGER = LoggerFactory.getLogger("BgfxCompiledRenderPipeline");
 
     private final RenderPipeline pipeline;
     private final BiFunction<ResourceLocation, ShaderType, String> shaderResolver;
-    private short programHandle = 0;
+    private short programHandle = BGFX.BGFX_INVALID_HANDLE;
+
+    // Sampler names declared by the pipeline and their BgfxUniformRegistry IDs, by texture stage
+    private final List<String> samplerNames;
+    private final int[] samplerIds;
+
+    // Precomputed bgfx_set_state() word, vertex format and sort mode
+    private final long state;
+    private final VertexFormat vertexFormat;
+    private final BgfxSortKeys.Mode sortMode;
 
     /**
      * Create a compiled render pipeline with default shader resolver
@@ -26,6 +44,11 @@ public class BgfxCompiledRenderPipeline implements CompiledRenderPipeline {
     public BgfxCompiledRenderPipeline(RenderPipeline pipeline) {
         this.pipeline = pipeline;
         this.shaderResolver = null;
+        this.samplerNames = pipeline.getSamplers();
+        this.samplerIds = internSamplers(samplerNames);
+        this.state = buildState(pipeline);
+        this.vertexFormat = pipeline.getVertexFormat();
+        this.sortMode = BgfxSortKeys.classify(pipeline);
         compilePipeline();
     }
 
@@ -35,46 +58,183 @@ public class BgfxCompiledRenderPipeline implements CompiledRenderPipeline {
     public BgfxCompiledRenderPipeline(RenderPipeline pipeline, BiFunction<ResourceLocation, ShaderType, String> shaderResolver) {
         this.pipeline = pipeline;
         this.shaderResolver = shaderResolver;
+        this.samplerNames = pipeline.getSamplers();
+        this.samplerIds = internSamplers(samplerNames);
+        this.state = buildState(pipeline);
+        this.vertexFormat = pipeline.getVertexFormat();
+        this.sortMode = BgfxSortKeys.classify(pipeline);
         compilePipeline();
     }
 
     /**
-     * Compile the render pipeline using BGFX native functionality
+     * Get this pipeline's program from BgfxProgramCache, shared with pipelines using the same shaders
      */
     private void compilePipeline() {
         try {
-            // Load basic shaders for the pipeline using BGFX
-            this.programHandle = Util.loadProgram("basic");
-            if (this.programHandle != 0) {
-                LOGGER.debug("Compiled BGFX render pipeline (program: {})", programHandle);
+            this.programHandle = BgfxProgramCache.acquire(pipeline);
+            if (Util.isValidHandle(this.programHandle)) {
+                LOGGER.debug("Compiled BGFX render pipeline {} (program: {})", pipeline.getLocation(), programHandle);
             } else {
-                LOGGER.warn("Failed to compile BGFX render pipeline, using fallback");
+                LOGGER.warn("Failed to compile BGFX render pipeline {}, using fallback", pipeline.getLocation());
             }
         } catch (Exception e) {
             LOGGER.error("Exception compiling render pipeline", e);
-            this.programHandle = 0;
+            this.programHandle = BGFX.BGFX_INVALID_HANDLE;
+        }
+    }
+
+    /**
+     * Intern sampler names up front so render passes never create sampler uniforms.
+     */
+    private static int[] internSamplers(List<String> names) {
+        int[] ids = new int[names.size()];
+        for (int i = 0; i < ids.length; i++) {
+            ids[i] = BgfxUniformRegistry.internSampler(names.get(i));
+        }
+        return ids;
+    }
+
+    /**
+     * Translate a pipeline's fixed-function state into a BGFX state word.
+     * BGFX has no polygon mode, logic op or depth bias render state; wireframe pipelines are drawn filled.
+     */
+    static long buildState(RenderPipeline pipeline) {
+        long state = BGFX.BGFX_STATE_MSAA;
+
+        if (pipeline.isWriteColor()) {
+            state |= BGFX.BGFX_STATE_WRITE_RGB;
         }
+        if (pipeline.isWriteAlpha()) {
+            state |= BGFX.BGFX_STATE_WRITE_A;
+        }
+        if (pipeline.isWriteDepth()) {
+            state |= BGFX.BGFX_STATE_WRITE_Z;
+        }
+
+        state |= switch (pipeline.getDepthTestFunction()) {
+            case NO_DEPTH_TEST -> 0L;
+            case EQUAL_DEPTH_TEST -> BGFX.BGFX_STATE_DEPTH_TEST_EQUAL;
+            case LEQUAL_DEPTH_TEST -> BGFX.BGFX_STATE_DEPTH_TEST_LEQUAL;
+            case LESS_DEPTH_TEST -> BGFX.BGFX_STATE_DEPTH_TEST_LESS;
+            case GREATER_DEPTH_TEST -> BGFX.BGFX_STATE_DEPTH_TEST_GREATER;
+        };
+
+        // Same winding as BgfxStateTracker: back faces of counter-clockwise geometry
+        if (pipeline.isCull()) {
+            state |= BGFX.BGFX_STATE_CULL_CW;
+        }
+
+        if (pipeline.getBlendFunction().isPresent()) {
+            BlendFunction blend = pipeline.getBlendFunction().get();
+            state |= BGFX.BGFX_STATE_BLEND_FUNC_SEPARATE(
+                blendFactor(blend.sourceColor().name()), blendFactor(blend.destColor().name()),
+                blendFactor(blend.sourceAlpha().name()), blendFactor(blend.destAlpha().name()));
+        }
+
+        // Quads, lines (expanded to quads), fans and triangles are all drawn as indexed triangle lists;
+        // line strips are expanded to triangle strips like in vanilla
+        state |= switch (pipeline.getVertexFormatMode()) {
+            case DEBUG_LINES -> BGFX.BGFX_STATE_PT_LINES;
+            case DEBUG_LINE_STRIP -> BGFX.BGFX_STATE_PT_LINESTRIP;
+            case TRIANGLE_STRIP, LINE_STRIP -> BGFX.BGFX_STATE_PT_TRISTRIP;
+            default -> 0L;
+        };
+
+        if (pipeline.getPolygonMode() == PolygonMode.WIREFRAME) {
+            LOGGER.debug("Pipeline {} uses wireframe polygon mode, drawing filled", pipeline.getLocation());
+        }
+        return state;
+    }
+
+    /**
+     * BGFX blend factor for a Minecraft source or destination factor (both enums share names).
+     */
+    private static long blendFactor(String factor) {
+        return switch (factor) {
+            case "ZERO" -> BGFX.BGFX_STATE_BLEND_ZERO;
+            case "ONE" -> BGFX.BGFX_STATE_BLEND_ONE;
+            case "SRC_COLOR" -> BGFX.BGFX_STATE_BLEND_SRC_COLOR;
+            case "ONE_MINUS_SRC_COLOR" -> BGFX.BGFX_STATE_BLEND_INV_SRC_COLOR;
+            case "SRC_ALPHA" -> BGFX.BGFX_STATE_BLEND_SRC_ALPHA;
+            case "ONE_MINUS_SRC_ALPHA" -> BGFX.BGFX_STATE_BLEND_INV_SRC_ALPHA;
+            case "DST_COLOR" -> BGFX.BGFX_STATE_BLEND_DST_COLOR;
+            case "ONE_MINUS_DST_COLOR" -> BGFX.BGFX_STATE_BLEND_INV_DST_COLOR;
+            case "DST_ALPHA" -> BGFX.BGFX_STATE_BLEND_DST_ALPHA;
+            case "ONE_MINUS_DST_ALPHA" -> BGFX.BGFX_STATE_BLEND_INV_DST_ALPHA;
+            case "SRC_ALPHA_SATURATE" -> BGFX.BGFX_STATE_BLEND_SRC_ALPHA_SAT;
+            case "CONSTANT_COLOR", "CONSTANT_ALPHA" -> BGFX.BGFX_STATE_BLEND_FACTOR;
+            case "ONE_MINUS_CONSTANT_COLOR", "ONE_MINUS_CONSTANT_ALPHA" -> BGFX.BGFX_STATE_BLEND_INV_FACTOR;
+            default -> {
+                LOGGER.warn("Unknown blend factor {}, using ONE", factor);
+                yield BGFX.BGFX_STATE_BLEND_ONE;
+            }
+        };
+    }
+
+    /**
+     * Precomputed BGFX render state for this pipeline's draws.
+     */
+    public long getState() {
+        return state;
+    }
+
+    public VertexFormat getVertexFormat() {
+        return vertexFormat;
+    }
+
+    /**
+     * BGFX vertex layout handle for this pipeline's vertex format.
+     */
+    public short getVertexLayout() {
+        return BgfxVertexLayouts.getHandle(vertexFormat);
+    }
+
+    public BgfxSortKeys.Mode getSortMode() {
+        return sortMode;
     }
 
     public short getProgramHandle() {
         return programHandle;
     }
 
+    public RenderPipeline getPipeline() {
+        return pipeline;
+    }
+
+    /**
+     * Texture stage of a sampler declared by this pipeline, or -1 if it is not declared.
+     */
+    public int getSamplerStage(String name) {
+        return samplerNames.indexOf(name);
+    }
+
+    public int getSamplerCount() {
+        return samplerIds.length;
+    }
+
+    /**
+     * BgfxUniformRegistry ID of the sampler at a texture stage.
+     */
+    public int getSamplerId(int stage) {
+        return samplerIds[stage];
+    }
+
     public boolean isValid() {
         // BGFX pipeline is valid if we have a program handle or if BGFX is initialized
-        return programHandle != 0 || Util.isInitialized();
+        return Util.isValidHandle(programHandle) || Util.isInitialized();
     }
 
     public void close() {
-        if (programHandle != 0) {
-            BgfxOperations.destroyResource(programHandle, "program");
-            programHandle = 0;
-            LOGGER.debug("Destroyed BGFX compiled pipeline program");
+        if (Util.isValidHandle(programHandle)) {
+            // The program is shared; BgfxProgramCache destroys it with its last pipeline
+            BgfxProgramCache.release(programHandle);
+            programHandle = BGFX.BGFX_INVALID_HANDLE;
+            LOGGER.debug("Released BGFX compiled pipeline program");
         }
     }
 
     @Override
     public String toString() {
-        return String.format("BgfxCompiledRenderPipeline{program=%d, valid=%s}", programHandle, isValid());
+        return String.format("BgfxCompiledRenderPipeline{program=%d, state=0x%016x, valid=%s}", programHandle, state, isValid());
     }
 }
\ No newline at end of file
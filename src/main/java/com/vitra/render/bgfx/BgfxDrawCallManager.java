@@ -8,24 +8,49 @@ import org.slf4j.LoggerFactory;
  * Manages draw call submission for BGFX rendering.
  *
  * This class uses ONLY BGFX's native methods:
- * - bgfx_set_vertex_buffer() - Bind vertex buffer for draw
- * - bgfx_set_index_buffer() - Bind index buffer for draw
- * - bgfx_set_state() - Set render state for draw
- * - bgfx_set_texture() - Bind texture for draw
- * - bgfx_submit() - Submit draw call to GPU
- * - bgfx_set_transient_vertex_buffer() - Bind transient vertex data
- * - bgfx_set_transient_index_buffer() - Bind transient index data
- * - bgfx_discard() - Discard pending draw state
+ * - bgfx_encoder_set_vertex_buffer() - Bind vertex buffer for draw
+ * - bgfx_encoder_set_index_buffer() - Bind index buffer for draw
+ * - bgfx_encoder_set_state() - Set render state for draw
+ * - bgfx_encoder_set_texture() - Bind texture for draw
+ * - bgfx_encoder_submit() - Submit draw call to GPU
+ * - bgfx_encoder_set_transient_vertex_buffer() - Bind transient vertex data
+ * - bgfx_encoder_set_transient_index_buffer() - Bind transient index data
+ * - bgfx_encoder_discard() - Discard pending draw state
  *
  * NO custom draw call batching or custom implementations.
  * All draw operations are delegated to BGFX's native API.
+ *
+ * Draws are recorded through a BGFX encoder: the render thread's main encoder by default, or a
+ * worker thread's own encoder (see BgfxEncoders).
  */
 public class BgfxDrawCallManager {
     private static final Logger LOGGER = LoggerFactory.getLogger("BgfxDrawCallManager");
 
+    // Encoder draws are recorded through; 0 = the render thread's main encoder
+    private final long encoder;
+
+    /**
+     * Draw call manager recording on the render thread.
+     */
+    public BgfxDrawCallManager() {
+        this(0L);
+    }
+
+    /**
+     * Draw call manager recording through an encoder from bgfx_encoder_begin(), for use on the
+     * thread that owns it (see BgfxEncoders.recordParallel()).
+     */
+    public BgfxDrawCallManager(long encoder) {
+        this.encoder = encoder;
+    }
+
+    private long encoder() {
+        return encoder != 0L ? encoder : BgfxEncoders.main();
+    }
+
     /**
      * Submit a draw call using vertex and index buffers.
-     * Uses: bgfx_set_vertex_buffer(), bgfx_set_index_buffer(), bgfx_set_state(), bgfx_submit()
+     * Uses: bgfx_encoder_set_vertex_buffer(), bgfx_encoder_set_index_buffer(), bgfx_encoder_set_state(), bgfx_encoder_submit()
      *
      * This method ONLY calls BGFX's native APIs in the correct order.
      *
@@ -42,16 +67,16 @@ public class BgfxDrawCallManager {
     public void submitIndexed(int viewId, short programHandle, short vertexBufferHandle, short indexBufferHandle,
                                long state, int startVertex, int numVertices, int startIndex, int numIndices) {
         // Set render state using BGFX native method
-        BGFX.bgfx_set_state(state, 0);
+        BGFX.bgfx_encoder_set_state(encoder(), state, 0);
 
         // Bind vertex buffer using BGFX native method
-        BGFX.bgfx_set_vertex_buffer(0, vertexBufferHandle, startVertex, numVertices);
+        BGFX.bgfx_encoder_set_vertex_buffer(encoder(), 0, vertexBufferHandle, startVertex, numVertices);
 
         // Bind index buffer using BGFX native method
-        BGFX.bgfx_set_index_buffer(indexBufferHandle, startIndex, numIndices);
+        BGFX.bgfx_encoder_set_index_buffer(encoder(), indexBufferHandle, startIndex, numIndices);
 
-        // Submit draw call using BGFX native method (viewId, program, depth, flags)
-        BGFX.bgfx_submit(viewId, programHandle, 0, BGFX.BGFX_DISCARD_NONE);
+        // Submit draw call using BGFX native method (viewId, program, sort depth, flags)
+        BGFX.bgfx_encoder_submit(encoder(), viewId, programHandle, sortDepth(viewId, state), BGFX.BGFX_DISCARD_NONE);
 
         LOGGER.trace("bgfx_submit(view={}, program={}, verts={}, indices={})",
             viewId, programHandle, numVertices, numIndices);
@@ -59,7 +84,7 @@ public class BgfxDrawCallManager {
 
     /**
      * Submit a draw call using only vertex buffer (non-indexed).
-     * Uses: bgfx_set_vertex_buffer(), bgfx_set_state(), bgfx_submit()
+     * Uses: bgfx_encoder_set_vertex_buffer(), bgfx_encoder_set_state(), bgfx_encoder_submit()
      *
      * @param viewId View ID (render pass)
      * @param programHandle BGFX program handle
@@ -71,20 +96,20 @@ public class BgfxDrawCallManager {
     public void submitNonIndexed(int viewId, short programHandle, short vertexBufferHandle,
                                   long state, int startVertex, int numVertices) {
         // Set render state using BGFX native method
-        BGFX.bgfx_set_state(state, 0);
+        BGFX.bgfx_encoder_set_state(encoder(), state, 0);
 
         // Bind vertex buffer using BGFX native method
-        BGFX.bgfx_set_vertex_buffer(0, vertexBufferHandle, startVertex, numVertices);
+        BGFX.bgfx_encoder_set_vertex_buffer(encoder(), 0, vertexBufferHandle, startVertex, numVertices);
 
-        // Submit draw call using BGFX native method (viewId, program, depth, flags)
-        BGFX.bgfx_submit(viewId, programHandle, 0, BGFX.BGFX_DISCARD_NONE);
+        // Submit draw call using BGFX native method (viewId, program, sort depth, flags)
+        BGFX.bgfx_encoder_submit(encoder(), viewId, programHandle, sortDepth(viewId, state), BGFX.BGFX_DISCARD_NONE);
 
         LOGGER.trace("bgfx_submit(view={}, program={}, verts={})", viewId, programHandle, numVertices);
     }
 
     /**
      * Submit a draw call using transient vertex and index data.
-     * Uses: bgfx_set_transient_vertex_buffer(), bgfx_set_transient_index_buffer(), bgfx_set_state(), bgfx_submit()
+     * Uses: bgfx_encoder_set_transient_vertex_buffer(), bgfx_encoder_set_transient_index_buffer(), bgfx_encoder_set_state(), bgfx_encoder_submit()
      *
      * Transient buffers are single-frame data managed internally by BGFX.
      *
@@ -99,34 +124,59 @@ public class BgfxDrawCallManager {
                                  org.lwjgl.bgfx.BGFXTransientIndexBuffer tib,
                                  long state) {
         // Set render state using BGFX native method
-        BGFX.bgfx_set_state(state, 0);
+        BGFX.bgfx_encoder_set_state(encoder(), state, 0);
 
         // Bind transient vertex buffer using BGFX native method
-        BGFX.bgfx_set_transient_vertex_buffer(0, tvb, 0, -1);
+        BGFX.bgfx_encoder_set_transient_vertex_buffer(encoder(), 0, tvb, 0, -1);
 
         // Bind transient index buffer using BGFX native method
-        BGFX.bgfx_set_transient_index_buffer(tib, 0, -1);
+        BGFX.bgfx_encoder_set_transient_index_buffer(encoder(), tib, 0, -1);
 
-        // Submit draw call using BGFX native method (viewId, program, depth, flags)
-        BGFX.bgfx_submit(viewId, programHandle, 0, BGFX.BGFX_DISCARD_NONE);
+        // Submit draw call using BGFX native method (viewId, program, sort depth, flags)
+        BGFX.bgfx_encoder_submit(encoder(), viewId, programHandle, sortDepth(viewId, state), BGFX.BGFX_DISCARD_NONE);
 
         LOGGER.trace("bgfx_submit(view={}, program={}, transient)", viewId, programHandle);
     }
 
+    /**
+     * Submit a draw call from a frame-scoped geometry range.
+     * Uses: bgfx_encoder_set_state(), bgfx_encoder_set_transient_*_buffer() / bgfx_encoder_set_dynamic_*_buffer(), bgfx_encoder_submit()
+     *
+     * The range decides whether its vertices and indices live in transient or pooled dynamic buffers.
+     *
+     * @param viewId View ID (render pass)
+     * @param programHandle BGFX program handle
+     * @param range Geometry range from BgfxFrameGeometry.allocate()
+     * @param state BGFX state flags (from BgfxStateTracker)
+     */
+    public void submitGeometry(int viewId, short programHandle, BgfxFrameGeometry.Range range, long state) {
+        // Set render state using BGFX native method
+        BGFX.bgfx_encoder_set_state(encoder(), state, 0);
+
+        // Bind vertex (and index, if present) range using BGFX native methods
+        range.bind(encoder());
+
+        // Submit draw call using BGFX native method (viewId, program, sort depth, flags)
+        BGFX.bgfx_encoder_submit(encoder(), viewId, programHandle, sortDepth(viewId, state), BGFX.BGFX_DISCARD_NONE);
+
+        LOGGER.trace("bgfx_submit(view={}, program={}, verts={}, indices={}, transient={})",
+            viewId, programHandle, range.getNumVertices(), range.getNumIndices(), range.isTransient());
+    }
+
     /**
      * Discard pending draw state without submitting.
-     * Uses: bgfx_discard()
+     * Uses: bgfx_encoder_discard()
      *
      * Use this to cancel a draw call setup if rendering is aborted.
      */
     public void discard() {
-        BGFX.bgfx_discard(0);
+        BGFX.bgfx_encoder_discard(encoder(), 0);
         LOGGER.trace("bgfx_discard()");
     }
 
     /**
      * Set render state before draw call.
-     * Uses: bgfx_set_state()
+     * Uses: bgfx_encoder_set_state()
      *
      * Convenience method for setting state separately from submit.
      *
@@ -134,13 +184,13 @@ public class BgfxDrawCallManager {
      * @param rgba RGBA value for blend factor (usually 0)
      */
     public void setState(long state, int rgba) {
-        BGFX.bgfx_set_state(state, rgba);
+        BGFX.bgfx_encoder_set_state(encoder(), state, rgba);
         LOGGER.trace("bgfx_set_state(0x{}, rgba=0x{})", Long.toHexString(state), Integer.toHexString(rgba));
     }
 
     /**
      * Set scissor rectangle for draw call.
-     * Uses: bgfx_set_scissor()
+     * Uses: bgfx_encoder_set_scissor()
      *
      * @param x Scissor X position
      * @param y Scissor Y position
@@ -149,8 +199,21 @@ public class BgfxDrawCallManager {
      * @return Scissor cache index for bgfx_set_scissor_cached()
      */
     public short setScissor(int x, int y, int width, int height) {
-        short cache = BGFX.bgfx_set_scissor(x, y, width, height);
+        short cache = BGFX.bgfx_encoder_set_scissor(encoder(), x, y, width, height);
         LOGGER.trace("bgfx_set_scissor({}, {}, {}, {}) -> cache={}", x, y, width, height, cache);
         return cache;
     }
+
+    /**
+     * Sort depth for a draw with the given state, registering its sort mode for the view.
+     * Immediate-mode draws carry no camera distance, so blended draws keep submission order.
+     */
+    private static int sortDepth(int viewId, long state) {
+        BgfxSortKeys.Mode mode = BgfxSortKeys.classify(state);
+        if (mode == BgfxSortKeys.Mode.TRANSLUCENT) {
+            mode = BgfxSortKeys.Mode.SEQUENTIAL;
+        }
+        BgfxSortKeys.requestViewMode(viewId, mode);
+        return BgfxSortKeys.key(mode, state, BGFX.BGFX_INVALID_HANDLE, 0.0f);
+    }
 }
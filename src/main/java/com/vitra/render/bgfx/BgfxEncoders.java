@@ -0,0 +1,156 @@
+package com.vitra.render.bgfx;
+
+import org.lwjgl.bgfx.BGFX;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+import java.util.ArrayList;
+import java.util.List;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.concurrent.atomic.AtomicInteger;
+
+/**
+ * BGFX encoders for recording draws, on the render thread and in parallel on worker threads.
+ *
+ * The render thread records through BGFX's main encoder ({@link #main()}). Large batches whose order
+ * BGFX decides anyway (sorted views, see BgfxSortKeys) can be split with {@link #recordParallel}:
+ * each slice is recorded by a pool thread on an encoder of its own, and BGFX merges all encoders'
+ * draws at bgfx_frame(). The render thread records the first slice itself and returns when every
+ * slice is recorded, so all worker encoders are ended before the frame is submitted.
+ *
+ * The pool has one thread per core beyond the render thread, capped so that together with the main
+ * encoder they stay within MAX_ENCODERS (passed to bgfx_init as limits.maxEncoders).
+ *
+ * Uses: bgfx_encoder_begin(), bgfx_encoder_end()
+ */
+public final class BgfxEncoders {
+    private static final Logger LOGGER = LoggerFactory.getLogger("BgfxEncoders");
+
+    // Encoders BGFX allocates at init: the main encoder plus one per pool thread
+    public static final int MAX_ENCODERS = 16;
+
+    private static final int WORKER_COUNT =
+        Math.max(0, Math.min(Runtime.getRuntime().availableProcessors() - 1, MAX_ENCODERS - 1));
+
+    /**
+     * Records one slice of a batch through the given encoder.
+     */
+    @FunctionalInterface
+    public interface Recorder<T> {
+        void record(long encoder, List<T> slice);
+    }
+
+    private static long mainEncoder = 0L;
+    private static ExecutorService workers;
+
+    /**
+     * The render thread's encoder (BGFX's main encoder). Must only be used on the render thread.
+     */
+    public static long main() {
+        if (mainEncoder == 0L) {
+            mainEncoder = BGFX.bgfx_encoder_begin(false);
+            if (mainEncoder == 0L) {
+                LOGGER.error("bgfx_encoder_begin(false) returned no encoder");
+            }
+        }
+        return mainEncoder;
+    }
+
+    /**
+     * Record a batch, split across worker encoders if it has at least minPerSlice items per slice.
+     * Returns once the whole batch is recorded. Slices are contiguous and in order; the first is
+     * recorded on the calling (render) thread through the main encoder.
+     *
+     * @param items Batch to record
+     * @param minPerSlice Smallest slice worth a worker
+     * @param recorder Records one slice; runs concurrently on several threads
+     * @return Number of slices the batch was recorded in
+     */
+    public static <T> int recordParallel(List<T> items, int minPerSlice, Recorder<T> recorder) {
+        int slices = Math.min(WORKER_COUNT + 1, items.size() / Math.max(minPerSlice, 1));
+        if (slices <= 1) {
+            recorder.record(main(), items);
+            return 1;
+        }
+
+        long encoder = main();
+        int size = items.size();
+        List<Future<?>> pending = new ArrayList<>(slices - 1);
+        List<List<T>> unrecorded = new ArrayList<>();
+        for (int i = 1; i < slices; i++) {
+            List<T> slice = items.subList(size * i / slices, size * (i + 1) / slices);
+            pending.add(pool().submit(() -> {
+                long workerEncoder = BGFX.bgfx_encoder_begin(true);
+                if (workerEncoder == 0L) {
+                    synchronized (unrecorded) {
+                        unrecorded.add(slice);
+                    }
+                    return;
+                }
+                try {
+                    recorder.record(workerEncoder, slice);
+                } finally {
+                    BGFX.bgfx_encoder_end(workerEncoder);
+                }
+            }));
+        }
+
+        recorder.record(encoder, items.subList(0, size / slices));
+
+        for (Future<?> future : pending) {
+            try {
+                future.get();
+            } catch (InterruptedException e) {
+                Thread.currentThread().interrupt();
+                throw new IllegalStateException("Interrupted while recording draws", e);
+            } catch (ExecutionException e) {
+                throw new IllegalStateException("Draw recording failed on a worker encoder", e.getCause());
+            }
+        }
+
+        // BGFX ran out of encoders: record what is left on the render thread
+        for (List<T> slice : unrecorded) {
+            LOGGER.warn("No free BGFX encoder, recording {} items on the render thread", slice.size());
+            recorder.record(encoder, slice);
+        }
+        return slices;
+    }
+
+    private static synchronized ExecutorService pool() {
+        if (workers == null) {
+            AtomicInteger index = new AtomicInteger();
+            workers = Executors.newFixedThreadPool(Math.max(WORKER_COUNT, 1), runnable -> {
+                Thread thread = new Thread(runnable, "Vitra-Encoder-" + index.incrementAndGet());
+                thread.setDaemon(true);
+                return thread;
+            });
+            LOGGER.info("Started {} encoder worker threads", Math.max(WORKER_COUNT, 1));
+        }
+        return workers;
+    }
+
+    /**
+     * Forget the main encoder; it is fetched again in the next frame. Called after bgfx_frame().
+     */
+    public static void endFrame() {
+        mainEncoder = 0L;
+    }
+
+    /**
+     * Stop the worker threads. Called on renderer shutdown.
+     */
+    public static synchronized void shutdown() {
+        mainEncoder = 0L;
+        if (workers != null) {
+            workers.shutdownNow();
+            workers = null;
+        }
+        LOGGER.info("Encoder workers shutdown complete");
+    }
+
+    private BgfxEncoders() {
+    }
+}
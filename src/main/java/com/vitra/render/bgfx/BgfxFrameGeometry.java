@@ -0,0 +1,350 @@
+package com.vitra.render.bgfx;
+
+import org.lwjgl.bgfx.BGFX;
+import org.lwjgl.bgfx.BGFXMemory;
+import org.lwjgl.bgfx.BGFXTransientIndexBuffer;
+import org.lwjgl.bgfx.BGFXTransientVertexBuffer;
+import org.lwjgl.bgfx.BGFXVertexLayout;
+import org.lwjgl.system.MemoryUtil;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+import java.nio.ByteBuffer;
+import java.util.ArrayDeque;
+import java.util.ArrayList;
+import java.util.List;
+
+/**
+ * Frame-scoped geometry storage for immediate-mode MeshData (GUI, entities, particles).
+ *
+ * Instead of creating an immutable BGFX buffer for every MeshData, geometry is packed into
+ * BGFX transient buffers, which BGFX recycles automatically after bgfx_frame():
+ * - bgfx_alloc_transient_vertex_buffer() / bgfx_alloc_transient_index_buffer()
+ *
+ * When the transient budget for the frame is exhausted, geometry falls back to a pool of
+ * dynamic buffers that are reused from frame to frame:
+ * - bgfx_create_dynamic_vertex_buffer() / bgfx_create_dynamic_index_buffer()
+ * - bgfx_update_dynamic_vertex_buffer() / bgfx_update_dynamic_index_buffer()
+ *
+ * Generated index patterns (QUADS, LINES, TRIANGLE_FAN) are not packed at all: ranges reference
+ * the matching BgfxSharedIndexBuffers buffer instead.
+ *
+ * All ranges handed out during a frame are recycled in {@link #endFrame()}, which must be
+ * called right after bgfx_frame(). Must only be used from the render thread.
+ */
+public final class BgfxFrameGeometry {
+    private static final Logger LOGGER = LoggerFactory.getLogger("BgfxFrameGeometry");
+
+    // Smallest pooled dynamic buffer, in elements (vertices or indices)
+    private static final int MIN_DYNAMIC_CAPACITY = 1024;
+
+    // Pooled dynamic buffers unused for this many frames are retired
+    private static final int MAX_IDLE_FRAMES = 300;
+
+    // Ranges handed out this frame, and recycled ranges ready for reuse
+    private static final List<Range> activeRanges = new ArrayList<>();
+    private static final ArrayDeque<Range> freeRanges = new ArrayDeque<>();
+
+    // Pooled dynamic buffers used when transient space runs out
+    private static final List<DynamicSlot> dynamicSlots = new ArrayList<>();
+
+    // Per-frame statistics
+    private static int transientRangesThisFrame = 0;
+    private static int dynamicRangesThisFrame = 0;
+
+    /**
+     * Vertex/index range for one MeshData, valid until the end of the current frame.
+     */
+    public static final class Range {
+        private final BGFXTransientVertexBuffer tvb = BGFXTransientVertexBuffer.calloc();
+        private final BGFXTransientIndexBuffer tib = BGFXTransientIndexBuffer.calloc();
+
+        private boolean transientVertices;
+        private boolean transientIndices;
+        private DynamicSlot vertexSlot;
+        private DynamicSlot indexSlot;
+        private short sharedIndexHandle = BGFX.BGFX_INVALID_HANDLE;
+        private int numVertices;
+        private int numIndices;
+
+        private Range() {
+        }
+
+        private void reset() {
+            transientVertices = false;
+            transientIndices = false;
+            vertexSlot = null;
+            indexSlot = null;
+            sharedIndexHandle = BGFX.BGFX_INVALID_HANDLE;
+            numVertices = 0;
+            numIndices = 0;
+        }
+
+        public int getNumVertices() {
+            return numVertices;
+        }
+
+        public int getNumIndices() {
+            return numIndices;
+        }
+
+        public boolean hasIndices() {
+            return numIndices > 0;
+        }
+
+        public boolean isTransient() {
+            return transientVertices;
+        }
+
+        /**
+         * Dynamic vertex buffer handle backing this range, or BGFX_INVALID_HANDLE for transient ranges.
+         */
+        public short getDynamicVertexHandle() {
+            return vertexSlot != null ? vertexSlot.handle : BGFX.BGFX_INVALID_HANDLE;
+        }
+
+        /**
+         * Dynamic index buffer handle backing this range, or BGFX_INVALID_HANDLE for transient/no indices.
+         */
+        public short getDynamicIndexHandle() {
+            return indexSlot != null ? indexSlot.handle : BGFX.BGFX_INVALID_HANDLE;
+        }
+
+        /**
+         * Bind this range for the next submit on an encoder.
+         * Uses: bgfx_encoder_set_transient_*_buffer() or bgfx_encoder_set_dynamic_*_buffer()
+         */
+        public void bind(long encoder) {
+            if (transientVertices) {
+                BGFX.bgfx_encoder_set_transient_vertex_buffer(encoder, 0, tvb, 0, numVertices);
+            } else {
+                BGFX.bgfx_encoder_set_dynamic_vertex_buffer(encoder, 0, vertexSlot.handle, 0, numVertices);
+            }
+
+            if (numIndices > 0) {
+                if (Util.isValidHandle(sharedIndexHandle)) {
+                    BGFX.bgfx_encoder_set_index_buffer(encoder, sharedIndexHandle, 0, numIndices);
+                } else if (transientIndices) {
+                    BGFX.bgfx_encoder_set_transient_index_buffer(encoder, tib, 0, numIndices);
+                } else {
+                    BGFX.bgfx_encoder_set_dynamic_index_buffer(encoder, indexSlot.handle, 0, numIndices);
+                }
+            }
+        }
+    }
+
+    /**
+     * Pooled dynamic buffer. Vertex slots are keyed by vertex layout hash,
+     * index slots by index width.
+     */
+    private static final class DynamicSlot {
+        final short handle;
+        final boolean index;
+        final int layoutHash;
+        final boolean index32;
+        final int capacity;
+        boolean inUse;
+        int idleFrames;
+
+        DynamicSlot(short handle, boolean index, int layoutHash, boolean index32, int capacity) {
+            this.handle = handle;
+            this.index = index;
+            this.layoutHash = layoutHash;
+            this.index32 = index32;
+            this.capacity = capacity;
+        }
+    }
+
+    /**
+     * Pack MeshData geometry into frame-scoped storage.
+     *
+     * @param vertexData Vertex bytes (position..limit)
+     * @param numVertices Number of vertices described by vertexData
+     * @param layout Vertex layout matching vertexData
+     * @param indexData Index bytes, or null for non-indexed geometry
+     * @param numIndices Number of indices in indexData
+     * @param index32 Whether indices are 32-bit
+     * @return Range to bind at draw time, or null if no storage could be allocated
+     */
+    public static Range allocate(ByteBuffer vertexData, int numVertices, BGFXVertexLayout layout,
+                                 ByteBuffer indexData, int numIndices, boolean index32) {
+        if (vertexData == null || numVertices <= 0 || layout == null) {
+            return null;
+        }
+
+        Range range = freeRanges.isEmpty() ? new Range() : freeRanges.poll();
+        range.reset();
+        range.numVertices = numVertices;
+
+        int vertexBytes = Math.min(vertexData.remaining(), numVertices * layout.stride());
+
+        // Vertices: transient first, pooled dynamic buffer as fallback
+        if (BGFX.bgfx_get_avail_transient_vertex_buffer(numVertices, layout) >= numVertices) {
+            BGFX.bgfx_alloc_transient_vertex_buffer(range.tvb, numVertices, layout);
+            MemoryUtil.memCopy(MemoryUtil.memAddress(vertexData), MemoryUtil.memAddress(range.tvb.data()), vertexBytes);
+            range.transientVertices = true;
+        } else {
+            range.vertexSlot = acquireSlot(false, layout.hash(), false, numVertices, layout);
+            if (range.vertexSlot == null) {
+                freeRanges.add(range);
+                return null;
+            }
+            BGFXMemory memory = BGFX.bgfx_copy(MemoryUtil.memSlice(vertexData, 0, vertexBytes));
+            BGFX.bgfx_update_dynamic_vertex_buffer(range.vertexSlot.handle, 0, memory);
+        }
+
+        // Indices: same strategy, independently of where the vertices went
+        if (indexData != null && numIndices > 0) {
+            int indexBytes = Math.min(indexData.remaining(), numIndices * (index32 ? 4 : 2));
+
+            if (BGFX.bgfx_get_avail_transient_index_buffer(numIndices, index32) >= numIndices) {
+                BGFX.bgfx_alloc_transient_index_buffer(range.tib, numIndices, index32);
+                MemoryUtil.memCopy(MemoryUtil.memAddress(indexData), MemoryUtil.memAddress(range.tib.data()), indexBytes);
+                range.transientIndices = true;
+                range.numIndices = numIndices;
+            } else {
+                range.indexSlot = acquireSlot(true, 0, index32, numIndices, null);
+                if (range.indexSlot != null) {
+                    BGFXMemory memory = BGFX.bgfx_copy(MemoryUtil.memSlice(indexData, 0, indexBytes));
+                    BGFX.bgfx_update_dynamic_index_buffer(range.indexSlot.handle, 0, memory);
+                    range.numIndices = numIndices;
+                } else {
+                    LOGGER.warn("No index storage for {} indices, drawing non-indexed", numIndices);
+                }
+            }
+        }
+
+        if (range.transientVertices) {
+            transientRangesThisFrame++;
+        } else {
+            dynamicRangesThisFrame++;
+        }
+
+        activeRanges.add(range);
+        return range;
+    }
+
+    /**
+     * Pack vertices into frame-scoped storage and index them with a shared generated pattern.
+     *
+     * @param vertexData Vertex bytes (position..limit)
+     * @param numVertices Number of vertices described by vertexData
+     * @param layout Vertex layout matching vertexData
+     * @param pattern Index pattern of the primitive mode (see BgfxSharedIndexBuffers.pattern())
+     * @return Range to bind at draw time, or null if no storage could be allocated
+     */
+    public static Range allocate(ByteBuffer vertexData, int numVertices, BGFXVertexLayout layout,
+                                 BgfxSharedIndexBuffers.Pattern pattern) {
+        Range range = allocate(vertexData, numVertices, layout, null, 0, false);
+        if (range != null && pattern != null) {
+            range.sharedIndexHandle = BgfxSharedIndexBuffers.getHandle(pattern, numVertices);
+            if (Util.isValidHandle(range.sharedIndexHandle)) {
+                range.numIndices = pattern.indexCount(numVertices);
+            }
+        }
+        return range;
+    }
+
+    /**
+     * Find a free pooled dynamic buffer large enough for the request, or create one.
+     */
+    private static DynamicSlot acquireSlot(boolean index, int layoutHash, boolean index32, int count, BGFXVertexLayout layout) {
+        for (DynamicSlot slot : dynamicSlots) {
+            if (!slot.inUse && slot.index == index && slot.capacity >= count
+                && (index ? slot.index32 == index32 : slot.layoutHash == layoutHash)) {
+                slot.inUse = true;
+                slot.idleFrames = 0;
+                return slot;
+            }
+        }
+
+        int capacity = Math.max(MIN_DYNAMIC_CAPACITY, Integer.highestOneBit(count - 1) << 1);
+        short handle = index
+            ? BgfxOperations.createDynamicIndexBuffer(capacity, index32 ? BGFX.BGFX_BUFFER_INDEX32 : BGFX.BGFX_BUFFER_NONE)
+            : BgfxOperations.createDynamicVertexBuffer(capacity, layout, BGFX.BGFX_BUFFER_NONE);
+
+        if (!Util.isValidHandle(handle)) {
+            LOGGER.error("Failed to create pooled dynamic {} buffer ({} elements)", index ? "index" : "vertex", capacity);
+            return null;
+        }
+
+        BgfxBufferLifetime.track(handle, slotType(index));
+        DynamicSlot slot = new DynamicSlot(handle, index, layoutHash, index32, capacity);
+        slot.inUse = true;
+        dynamicSlots.add(slot);
+        LOGGER.debug("Created pooled dynamic {} buffer: handle={}, capacity={}", index ? "index" : "vertex", handle, capacity);
+        return slot;
+    }
+
+    private static int slotType(boolean index) {
+        return index ? Util.RESOURCE_DYNAMIC_INDEX_BUFFER : Util.RESOURCE_DYNAMIC_VERTEX_BUFFER;
+    }
+
+    /**
+     * Recycle all ranges handed out this frame and retire pooled buffers that have gone idle.
+     * Must be called after bgfx_frame(), when BGFX has released the frame's transient memory.
+     */
+    public static void endFrame() {
+        if (dynamicRangesThisFrame > 0) {
+            LOGGER.trace("Frame geometry: {} transient ranges, {} dynamic fallback ranges",
+                transientRangesThisFrame, dynamicRangesThisFrame);
+        }
+
+        for (Range range : activeRanges) {
+            if (range.vertexSlot != null) {
+                range.vertexSlot.inUse = false;
+            }
+            if (range.indexSlot != null) {
+                range.indexSlot.inUse = false;
+            }
+            range.reset();
+            freeRanges.add(range);
+        }
+        activeRanges.clear();
+
+        // Slots used this frame were reset to 0 in acquireSlot(); retirement is frame-fenced
+        dynamicSlots.removeIf(slot -> {
+            if (++slot.idleFrames < MAX_IDLE_FRAMES) {
+                return false;
+            }
+            LOGGER.debug("Retiring idle pooled dynamic {} buffer: handle={}", slot.index ? "index" : "vertex", slot.handle);
+            BgfxBufferLifetime.retire(slot.handle, slotType(slot.index));
+            return true;
+        });
+
+        transientRangesThisFrame = 0;
+        dynamicRangesThisFrame = 0;
+    }
+
+    public static int getTransientRangesThisFrame() {
+        return transientRangesThisFrame;
+    }
+
+    public static int getDynamicRangesThisFrame() {
+        return dynamicRangesThisFrame;
+    }
+
+    /**
+     * Retire all pooled dynamic buffers and free native range structs.
+     * Retired handles are destroyed by BgfxBufferLifetime.flush() during shutdown.
+     */
+    public static void shutdown() {
+        for (DynamicSlot slot : dynamicSlots) {
+            BgfxBufferLifetime.retire(slot.handle, slotType(slot.index));
+        }
+        dynamicSlots.clear();
+
+        activeRanges.forEach(range -> freeRanges.add(range));
+        activeRanges.clear();
+        for (Range range : freeRanges) {
+            range.tvb.free();
+            range.tib.free();
+        }
+        freeRanges.clear();
+
+        LOGGER.info("Frame geometry shutdown complete");
+    }
+
+    private BgfxFrameGeometry() {
+    }
+}
@@ -0,0 +1,42 @@
+package com.vitra.render.bgfx;
+
+import com.mojang.blaze3d.vertex.ByteBufferBuilder;
+import com.mojang.blaze3d.vertex.MeshData;
+import com.vitra.mixin.MeshDataAccessor;
+
+import java.nio.ByteBuffer;
+
+/**
+ * Shared, reflection-free access to MeshData contents for the build and draw mixins.
+ *
+ * Backed by the MeshDataAccessor mixin interface, so every read compiles to a direct
+ * field access. This is NOT a mixin, so it can expose public static helpers.
+ */
+public final class BgfxMeshData {
+
+    /**
+     * Vertex bytes of the mesh, or null if the mesh has no vertex data.
+     */
+    public static ByteBuffer vertexData(MeshData meshData) {
+        ByteBufferBuilder.Result result = ((MeshDataAccessor) (Object) meshData).vitra$getVertexBuffer();
+        return result != null ? result.byteBuffer() : null;
+    }
+
+    /**
+     * Explicit index bytes of the mesh, or null for sequentially indexed meshes (e.g. QUADS).
+     */
+    public static ByteBuffer indexData(MeshData meshData) {
+        ByteBufferBuilder.Result result = ((MeshDataAccessor) (Object) meshData).vitra$getIndexBuffer();
+        return result != null ? result.byteBuffer() : null;
+    }
+
+    /**
+     * Draw parameters (format, vertex/index counts, mode, index type) of the mesh.
+     */
+    public static MeshData.DrawState drawState(MeshData meshData) {
+        return ((MeshDataAccessor) (Object) meshData).vitra$getDrawState();
+    }
+
+    private BgfxMeshData() {
+    }
+}
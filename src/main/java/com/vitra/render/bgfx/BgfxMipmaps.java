@@ -0,0 +1,345 @@
+package com.vitra.render.bgfx;
+
+import org.lwjgl.bgfx.BGFX;
+import org.lwjgl.system.MemoryUtil;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+import java.nio.ByteBuffer;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.Set;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.ForkJoinPool;
+import java.util.concurrent.ForkJoinTask;
+import java.util.concurrent.ForkJoinWorkerThread;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * CPU mip chain generation for RGBA8 and R8 textures whose base level is uploaded without its mips.
+ *
+ * BGFX does not generate mips for textures updated at runtime: a texture created with mips and only
+ * given level 0 samples undefined data further away. Such textures keep a {@link Chain}, a native
+ * copy of every level. Writes to level 0 are staged in the chain as copies of just the written
+ * region; at the end of the frame ({@link #flush()}) dirty chains are rebuilt on a ForkJoin pool:
+ * the staged writes are applied to level 0 and only the part of each level below their bounding
+ * rectangle is recomputed, split into bands of rows filtered in parallel (see
+ * BgfxPixelKernels.downsampleRgba8 for the alpha-aware box filter). All rebuilt levels are then
+ * uploaded in one queued render command.
+ *
+ * Textures that upload their own mips (Minecraft's atlases build theirs when stitching) drop their
+ * chain on the first write above level 0 (see BgfxTexture). That write comes in the same frame as
+ * the level 0 writes, so their staged copies are released before any level is allocated.
+ *
+ * Thread-safe: a chain is locked while it is written or rebuilt.
+ *
+ * Uses: bgfx_update_texture_2d()
+ */
+public final class BgfxMipmaps {
+    private static final Logger LOGGER = LoggerFactory.getLogger("BgfxMipmaps");
+
+    // Destination rows filtered per task
+    private static final int BAND_ROWS = 32;
+
+    // Created on first use and dropped on shutdown, so a re-initialized renderer gets a fresh pool
+    private static ForkJoinPool pool;
+
+    private static final Set<Chain> dirtyChains = ConcurrentHashMap.newKeySet();
+
+    /**
+     * Native copy of a texture's mip levels, tightly packed. Levels are allocated on first use.
+     */
+    public static final class Chain {
+        private final String name;
+        private final short handle;
+        private final int width;
+        private final int height;
+        private final int bytesPerPixel;
+        private final long[] levels;
+
+        // Level 0 writes since the last rebuild
+        private final List<StagedWrite> staged = new ArrayList<>();
+
+        private volatile boolean released;
+
+        private Chain(String name, short handle, int width, int height, int levelCount, int bytesPerPixel) {
+            this.name = name;
+            this.handle = handle;
+            this.width = width;
+            this.height = height;
+            this.bytesPerPixel = bytesPerPixel;
+            this.levels = new long[levelCount];
+        }
+
+        public int getBytesPerPixel() {
+            return bytesPerPixel;
+        }
+
+        private int levelWidth(int level) {
+            return Math.max(1, width >> level);
+        }
+
+        private int levelHeight(int level) {
+            return Math.max(1, height >> level);
+        }
+
+        private long level(int level) {
+            if (levels[level] == MemoryUtil.NULL) {
+                levels[level] = MemoryUtil.nmemCallocChecked(1, (long) levelWidth(level) * levelHeight(level) * bytesPerPixel);
+            }
+            return levels[level];
+        }
+    }
+
+    /**
+     * Create the chain of a texture, or null if its format or level count needs none.
+     */
+    public static Chain createChain(String name, short handle, int width, int height, int levelCount, int bgfxFormat) {
+        if (levelCount < 2) {
+            return null;
+        }
+        if (bgfxFormat == BGFX.BGFX_TEXTURE_FORMAT_RGBA8) {
+            return new Chain(name, handle, width, height, levelCount, 4);
+        }
+        if (bgfxFormat == BGFX.BGFX_TEXTURE_FORMAT_R8) {
+            return new Chain(name, handle, width, height, levelCount, 1);
+        }
+        return null;
+    }
+
+    /**
+     * A level 0 region waiting for the next rebuild; block holds its texels tightly packed.
+     */
+    private record StagedWrite(int x, int y, int width, int height, ByteBuffer block) {
+    }
+
+    /**
+     * Stage a region written to level 0 (rows srcPitch bytes apart) and mark the chain for rebuild.
+     */
+    public static void write(Chain chain, int x, int y, int width, int height, long srcAddress, int srcPitch) {
+        int x1 = Math.min(x + width, chain.width);
+        int y1 = Math.min(y + height, chain.height);
+        if (x < 0 || y < 0 || x1 <= x || y1 <= y) {
+            return;
+        }
+
+        int rowBytes = (x1 - x) * chain.bytesPerPixel;
+        ByteBuffer block = BgfxUploadPool.acquire(rowBytes * (y1 - y));
+        long dst = MemoryUtil.memAddress(block);
+        for (int row = 0; row < y1 - y; row++) {
+            MemoryUtil.memCopy(srcAddress + (long) row * srcPitch, dst + (long) row * rowBytes, rowBytes);
+        }
+
+        synchronized (chain) {
+            if (chain.released) {
+                BgfxUploadPool.release(block);
+                return;
+            }
+            chain.staged.add(new StagedWrite(x, y, x1 - x, y1 - y, block));
+        }
+        dirtyChains.add(chain);
+    }
+
+    /**
+     * Start rebuilding every chain written this frame. Called right before bgfx_frame(); the uploads
+     * are queued on BgfxRenderQueue when the rebuilds finish.
+     */
+    public static void flush() {
+        if (dirtyChains.isEmpty()) {
+            return;
+        }
+        ForkJoinPool executor = pool();
+        for (Chain chain : dirtyChains) {
+            dirtyChains.remove(chain);
+            if (!chain.released) {
+                executor.execute(() -> rebuild(chain));
+            }
+        }
+    }
+
+    private static synchronized ForkJoinPool pool() {
+        if (pool == null) {
+            pool = new ForkJoinPool(
+                Math.max(1, Runtime.getRuntime().availableProcessors() / 2),
+                p -> {
+                    ForkJoinWorkerThread thread = ForkJoinPool.defaultForkJoinWorkerThreadFactory.newThread(p);
+                    thread.setName("Vitra Mipmaps-" + thread.getPoolIndex());
+                    return thread;
+                },
+                (thread, e) -> LOGGER.error("Mipmap generation failed", e),
+                false);
+        }
+        return pool;
+    }
+
+    /**
+     * One level region to upload: block holds its texels tightly packed.
+     */
+    private record LevelUpdate(int level, int x, int y, int width, int height, ByteBuffer block) {
+    }
+
+    private static void rebuild(Chain chain) {
+        List<LevelUpdate> updates = new ArrayList<>(chain.levels.length - 1);
+        synchronized (chain) {
+            if (chain.released || chain.staged.isEmpty()) {
+                return;
+            }
+
+            // Apply the staged writes to level 0 (allocated here, the first time) and bound them
+            int x0 = Integer.MAX_VALUE;
+            int y0 = Integer.MAX_VALUE;
+            int x1 = 0;
+            int y1 = 0;
+            int bpp = chain.bytesPerPixel;
+            int levelPitch = chain.width * bpp;
+            long base = chain.level(0);
+            for (StagedWrite write : chain.staged) {
+                int rowBytes = write.width() * bpp;
+                long src = MemoryUtil.memAddress(write.block());
+                long dst = base + (long) write.y() * levelPitch + (long) write.x() * bpp;
+                for (int row = 0; row < write.height(); row++) {
+                    MemoryUtil.memCopy(src + (long) row * rowBytes, dst + (long) row * levelPitch, rowBytes);
+                }
+                BgfxUploadPool.release(write.block());
+                x0 = Math.min(x0, write.x());
+                y0 = Math.min(y0, write.y());
+                x1 = Math.max(x1, write.x() + write.width());
+                y1 = Math.max(y1, write.y() + write.height());
+            }
+            chain.staged.clear();
+
+            for (int level = 1; level < chain.levels.length; level++) {
+                // Destination texels whose 2x2 source block touches the dirty region
+                int levelWidth = chain.levelWidth(level);
+                int levelHeight = chain.levelHeight(level);
+                x0 = Math.min(x0 >> 1, levelWidth - 1);
+                y0 = Math.min(y0 >> 1, levelHeight - 1);
+                x1 = Math.min((x1 + 1) >> 1, levelWidth);
+                y1 = Math.min((y1 + 1) >> 1, levelHeight);
+                downsample(chain, level, x0, y0, x1, y1);
+                updates.add(pack(chain, level, x0, y0, x1 - x0, y1 - y0));
+            }
+        }
+
+        LOGGER.trace("Rebuilt {} mip levels of {}", updates.size(), chain.name);
+        BgfxRenderQueue.execute(new BgfxRenderQueue.Command() {
+            @Override
+            public void run() {
+                if (chain.released) {
+                    discard();
+                    return;
+                }
+                for (LevelUpdate update : updates) {
+                    BGFX.bgfx_update_texture_2d(chain.handle, 0, (byte) update.level(), (short) update.x(), (short) update.y(),
+                        (short) update.width(), (short) update.height(), BgfxUploadPool.submit(update.block()), (short) 0xFFFF);
+                }
+            }
+
+            @Override
+            public void discard() {
+                for (LevelUpdate update : updates) {
+                    BgfxUploadPool.release(update.block());
+                }
+            }
+        });
+    }
+
+    /**
+     * Filter a region of a level from the level above, in bands of rows on the pool.
+     */
+    private static void downsample(Chain chain, int level, int x0, int y0, int x1, int y1) {
+        int bpp = chain.bytesPerPixel;
+        int srcWidth = chain.levelWidth(level - 1);
+        int srcHeight = chain.levelHeight(level - 1);
+        int dstWidth = chain.levelWidth(level);
+        long src = chain.level(level - 1);
+        long dst = chain.level(level);
+        // A one texel wide or high source is filtered against itself
+        int pixelStep = srcWidth > 1 ? bpp : 0;
+        int rowStep = srcHeight > 1 ? 1 : 0;
+
+        List<ForkJoinTask<?>> bands = new ArrayList<>();
+        for (int bandY = y0; bandY < y1; bandY += BAND_ROWS) {
+            int bandStart = bandY;
+            int bandEnd = Math.min(bandY + BAND_ROWS, y1);
+            bands.add(ForkJoinTask.adapt(() -> {
+                for (int y = bandStart; y < bandEnd; y++) {
+                    long row0 = src + ((long) y * 2 * srcWidth + (long) x0 * 2) * bpp;
+                    long row1 = row0 + (long) rowStep * srcWidth * bpp;
+                    long out = dst + ((long) y * dstWidth + x0) * bpp;
+                    if (bpp == 4) {
+                        BgfxPixelKernels.downsampleRgba8(row0, row1, out, x1 - x0, pixelStep);
+                    } else {
+                        BgfxPixelKernels.downsampleR8(row0, row1, out, x1 - x0, pixelStep);
+                    }
+                }
+            }));
+        }
+        ForkJoinTask.invokeAll(bands);
+    }
+
+    /**
+     * Copy a region of a level into an upload block.
+     */
+    private static LevelUpdate pack(Chain chain, int level, int x, int y, int width, int height) {
+        int bpp = chain.bytesPerPixel;
+        int rowBytes = width * bpp;
+        int levelPitch = chain.levelWidth(level) * bpp;
+        ByteBuffer block = BgfxUploadPool.acquire(rowBytes * height);
+        long src = chain.level(level) + (long) y * levelPitch + (long) x * bpp;
+        long dst = MemoryUtil.memAddress(block);
+        for (int row = 0; row < height; row++) {
+            MemoryUtil.memCopy(src + (long) row * levelPitch, dst + (long) row * rowBytes, rowBytes);
+        }
+        return new LevelUpdate(level, x, y, width, height, block);
+    }
+
+    /**
+     * Free a chain. Called when its texture is destroyed or starts uploading its own mips.
+     */
+    public static void release(Chain chain) {
+        chain.released = true;
+        dirtyChains.remove(chain);
+        synchronized (chain) {
+            for (StagedWrite write : chain.staged) {
+                BgfxUploadPool.release(write.block());
+            }
+            chain.staged.clear();
+            for (int i = 0; i < chain.levels.length; i++) {
+                if (chain.levels[i] != MemoryUtil.NULL) {
+                    MemoryUtil.nmemFree(chain.levels[i]);
+                    chain.levels[i] = MemoryUtil.NULL;
+                }
+            }
+        }
+    }
+
+    /**
+     * Stop the pool and drop pending rebuilds. Called on renderer shutdown.
+     */
+    public static void shutdown() {
+        ForkJoinPool executor;
+        synchronized (BgfxMipmaps.class) {
+            executor = pool;
+            pool = null;
+        }
+        if (executor != null) {
+            executor.shutdownNow();
+            try {
+                // Rebuilds still running queue their uploads; let them finish before the render queue is dropped
+                if (!executor.awaitTermination(1, TimeUnit.SECONDS)) {
+                    LOGGER.warn("Mipmap rebuilds still running at shutdown");
+                }
+            } catch (InterruptedException e) {
+                Thread.currentThread().interrupt();
+            }
+        }
+        for (Chain chain : dirtyChains) {
+            release(chain);
+        }
+        LOGGER.info("Mipmap generator shutdown complete");
+    }
+
+    private BgfxMipmaps() {
+    }
+}
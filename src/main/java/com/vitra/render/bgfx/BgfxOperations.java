@@ -1,13 +1,13 @@
 package com.vitra.render.bgfx;
 
+import com.mojang.blaze3d.platform.NativeImage;
+import com.mojang.blaze3d.vertex.DefaultVertexFormat;
 import org.lwjgl.bgfx.BGFX;
 import org.lwjgl.bgfx.BGFXMemory;
 import org.lwjgl.bgfx.BGFXTextureInfo;
 import org.lwjgl.bgfx.BGFXTransientVertexBuffer;
 import org.lwjgl.bgfx.BGFXTransientIndexBuffer;
 import org.lwjgl.bgfx.BGFXVertexLayout;
-import org.lwjgl.system.MemoryStack;
-import org.lwjgl.system.MemoryUtil;
 import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 
@@ -20,59 +20,19 @@ import java.nio.ByteBuffer;
 public class BgfxOperations {
     private static final Logger LOGGER = LoggerFactory.getLogger("BgfxOperations");
 
-    // Cached vertex layouts to avoid recreation
-    private static BGFXVertexLayout cachedPositionTexColorLayout;
-    private static BGFXVertexLayout cachedPositionLayout;
-    private static BGFXVertexLayout cachedPositionTexLayout;
-
-    static {
-        initializeCachedLayouts();
-    }
-
-    /**
-     * Initialize cached vertex layouts for better performance
-     */
-    private static void initializeCachedLayouts() {
-        try (MemoryStack stack = MemoryStack.stackPush()) {
-            // Position + TexCoord + Color (most common for Minecraft)
-            cachedPositionTexColorLayout = BGFXVertexLayout.malloc(stack);
-            BGFX.bgfx_vertex_layout_begin(cachedPositionTexColorLayout, BGFX.BGFX_RENDERER_TYPE_NOOP);
-            BGFX.bgfx_vertex_layout_add(cachedPositionTexColorLayout, BGFX.BGFX_ATTRIB_POSITION, 3, BGFX.BGFX_ATTRIB_TYPE_FLOAT, false, false);
-            BGFX.bgfx_vertex_layout_add(cachedPositionTexColorLayout, BGFX.BGFX_ATTRIB_TEXCOORD0, 2, BGFX.BGFX_ATTRIB_TYPE_FLOAT, false, false);
-            BGFX.bgfx_vertex_layout_add(cachedPositionTexColorLayout, BGFX.BGFX_ATTRIB_COLOR0, 4, BGFX.BGFX_ATTRIB_TYPE_UINT8, true, true);
-            BGFX.bgfx_vertex_layout_end(cachedPositionTexColorLayout);
-
-            // Position only
-            cachedPositionLayout = BGFXVertexLayout.malloc(stack);
-            BGFX.bgfx_vertex_layout_begin(cachedPositionLayout, BGFX.BGFX_RENDERER_TYPE_NOOP);
-            BGFX.bgfx_vertex_layout_add(cachedPositionLayout, BGFX.BGFX_ATTRIB_POSITION, 3, BGFX.BGFX_ATTRIB_TYPE_FLOAT, false, false);
-            BGFX.bgfx_vertex_layout_end(cachedPositionLayout);
-
-            // Position + TexCoord
-            cachedPositionTexLayout = BGFXVertexLayout.malloc(stack);
-            BGFX.bgfx_vertex_layout_begin(cachedPositionTexLayout, BGFX.BGFX_RENDERER_TYPE_NOOP);
-            BGFX.bgfx_vertex_layout_add(cachedPositionTexLayout, BGFX.BGFX_ATTRIB_POSITION, 3, BGFX.BGFX_ATTRIB_TYPE_FLOAT, false, false);
-            BGFX.bgfx_vertex_layout_add(cachedPositionTexLayout, BGFX.BGFX_ATTRIB_TEXCOORD0, 2, BGFX.BGFX_ATTRIB_TYPE_FLOAT, false, false);
-            BGFX.bgfx_vertex_layout_end(cachedPositionTexLayout);
-
-            LOGGER.info("BGFX vertex layouts cached successfully");
-        } catch (Exception e) {
-            LOGGER.error("Failed to initialize cached BGFX vertex layouts", e);
-        }
-    }
-
     // ==================== VERTEX LAYOUT OPERATIONS ====================
+    // Layouts are owned by BgfxVertexLayouts (persistent, heap-allocated, one per VertexFormat)
 
     public static BGFXVertexLayout getPositionTexColorLayout() {
-        return cachedPositionTexColorLayout;
+        return BgfxVertexLayouts.get(DefaultVertexFormat.POSITION_TEX_COLOR);
     }
 
     public static BGFXVertexLayout getPositionLayout() {
-        return cachedPositionLayout;
+        return BgfxVertexLayouts.get(DefaultVertexFormat.POSITION);
     }
 
     public static BGFXVertexLayout getPositionTexLayout() {
-        return cachedPositionTexLayout;
+        return BgfxVertexLayouts.get(DefaultVertexFormat.POSITION_TEX);
     }
 
     // ==================== BUFFER OPERATIONS ====================
@@ -96,8 +56,15 @@ public class BgfxOperations {
      * BGFX handles all validation internally.
      */
     public static short createIndexBuffer(ByteBuffer data, int flags) {
+        return createIndexBuffer(BGFX.bgfx_copy(data), flags);
+    }
+
+    /**
+     * Create an index buffer from BGFX memory, e.g. a zero-copy BgfxUploadPool block.
+     * BGFX handles all validation internally.
+     */
+    public static short createIndexBuffer(BGFXMemory memory, int flags) {
         try {
-            BGFXMemory memory = BGFX.bgfx_copy(data);
             return BGFX.bgfx_create_index_buffer(memory, flags);
         } catch (Exception e) {
             LOGGER.error("Failed to create index buffer", e);
@@ -132,13 +99,20 @@ public class BgfxOperations {
     }
 
     /**
-     * Update a dynamic buffer (vertex or index).
-     * BGFX handles all validation internally.
+     * Update a dynamic buffer (vertex or index) from caller-owned memory.
+     * The data is copied, so the caller may reuse it immediately; use the BGFXMemory
+     * overload with BgfxUploadPool.submit() for memory that can be handed to BGFX.
      */
     public static boolean updateDynamicBuffer(short handle, int offset, ByteBuffer data, boolean isVertexBuffer) {
-        try {
-            BGFXMemory memory = BGFX.bgfx_copy(data);
+        return updateDynamicBuffer(handle, offset, BGFX.bgfx_copy(data), isVertexBuffer);
+    }
 
+    /**
+     * Update a dynamic buffer (vertex or index) from BGFX memory, e.g. a zero-copy BgfxUploadPool block.
+     * BGFX handles all validation internally.
+     */
+    public static boolean updateDynamicBuffer(short handle, int offset, BGFXMemory memory, boolean isVertexBuffer) {
+        try {
             if (isVertexBuffer) {
                 BGFX.bgfx_update_dynamic_vertex_buffer(handle, offset, memory);
             } else {
@@ -186,7 +160,7 @@ public class BgfxOperations {
      * Create a 2D texture using BGFX native functionality.
      * BGFX handles all validation internally.
      */
-    public static short createTexture2D(int width, int height, boolean hasMips, int numLayers, int format, int flags) {
+    public static short createTexture2D(int width, int height, boolean hasMips, int numLayers, int format, long flags) {
         try {
             return BGFX.bgfx_create_texture_2d(width, height, hasMips, numLayers, format, flags, null);
         } catch (Exception e) {
@@ -196,18 +170,76 @@ public class BgfxOperations {
     }
 
     /**
-     * Update texture data.
-     * BGFX handles all validation internally.
+     * Update texture data from caller-owned memory.
+     * The data is copied; use the BGFXMemory overload with BgfxUploadPool.submit() to avoid the copy.
      */
     public static boolean updateTexture2D(short textureHandle, int mipLevel, int x, int y, int width, int height, ByteBuffer data) {
-        try {
-            BGFXMemory memory = BGFX.bgfx_copy(data);
-            BGFX.bgfx_update_texture_2d(textureHandle, mipLevel, x, y, 0, width, height, memory, 0xFFFF);
-            return true;
-        } catch (Exception e) {
-            LOGGER.error("Failed to update texture", e);
-            return false;
+        return updateTexture2D(textureHandle, mipLevel, x, y, width, height, BGFX.bgfx_copy(data));
+    }
+
+    /**
+     * Update texture data from BGFX memory, e.g. a zero-copy BgfxUploadPool block.
+     * BGFX handles all validation internally.
+     */
+    public static boolean updateTexture2D(short textureHandle, int mipLevel, int x, int y, int width, int height, BGFXMemory memory) {
+        return updateTexture2D(textureHandle, mipLevel, x, y, width, height, memory, DERIVED_PITCH);
+    }
+
+    /**
+     * Update texture data from BGFX memory whose rows are pitch bytes apart.
+     * Runs through BgfxRenderQueue, so it may be called from any thread once the memory is staged.
+     * BGFX handles all validation internally.
+     */
+    public static boolean updateTexture2D(short textureHandle, int mipLevel, int x, int y, int width, int height,
+                                          BGFXMemory memory, int pitch) {
+        BgfxRenderQueue.execute(() -> {
+            try {
+                BGFX.bgfx_update_texture_2d(
+                    textureHandle,
+                    0,           // layer
+                    (byte) mipLevel,
+                    (short) x,
+                    (short) y,
+                    (short) width,
+                    (short) height,
+                    memory,
+                    (short) pitch
+                );
+            } catch (Exception e) {
+                LOGGER.error("Failed to update texture", e);
+            }
+        });
+        return true;
+    }
+
+    // bgfx_update_texture_2d pitch meaning "derive from width and format"; also the largest pitch BGFX takes
+    private static final int DERIVED_PITCH = 0xFFFF;
+
+    /**
+     * Update a texture region from a region of a NativeImage (srcX, srcY = Minecraft's skipPixels, skipRows),
+     * read straight from the image's native pixels. The region is clipped to the image.
+     *
+     * The region is copied once, native to native, and staged in BgfxUploadCoalescer, which merges the
+     * frame's writes to the texture (e.g. animated atlas sprites) into as few updates as possible.
+     */
+    public static boolean updateTexture2D(short textureHandle, int mipLevel, int x, int y, int width, int height,
+                                          NativeImage image, int srcX, int srcY) {
+        int clippedWidth = Math.min(width, image.getWidth() - srcX);
+        int clippedHeight = Math.min(height, image.getHeight() - srcY);
+        if (srcX < 0 || srcY < 0 || clippedWidth != width || clippedHeight != height) {
+            LOGGER.warn("Upload region {}x{} at {},{} exceeds {}x{} image, clipping", width, height, srcX, srcY,
+                image.getWidth(), image.getHeight());
+            if (srcX < 0 || srcY < 0 || clippedWidth <= 0 || clippedHeight <= 0) {
+                return false;
+            }
         }
+
+        int bytesPerPixel = image.format().components();
+        int srcPitch = image.getWidth() * bytesPerPixel;
+        long srcAddress = image.getPointer() + (long) srcY * srcPitch + (long) srcX * bytesPerPixel;
+        BgfxUploadCoalescer.write(textureHandle, () -> textureHandle, mipLevel, bytesPerPixel,
+            x, y, clippedWidth, clippedHeight, srcAddress, srcPitch);
+        return true;
     }
 
     /**
@@ -222,18 +254,6 @@ public class BgfxOperations {
 
     // ==================== COMMAND ENCODER OPERATIONS ====================
 
-    /**
-     * Set scissor rect using BGFX native functionality.
-     * BGFX handles all validation internally.
-     */
-    public static void setScissorRect(int x, int y, int width, int height) {
-        try {
-            BGFX.bgfx_set_view_scissor(0, (short)x, (short)y, (short)width, (short)height);
-        } catch (Exception e) {
-            LOGGER.error("Failed to set scissor rect", e);
-        }
-    }
-
     /**
      * Blit texture using BGFX native functionality.
      * BGFX handles all validation internally.
@@ -284,7 +304,10 @@ public class BgfxOperations {
                     BGFX.bgfx_destroy_dynamic_index_buffer(handle);
                     break;
                 case "texture":
-                    BGFX.bgfx_destroy_texture(handle);
+                    // Queued behind updates still pending for the handle, so none runs on a destroyed
+                    // (or recycled) texture
+                    BgfxUploadCoalescer.release(handle);
+                    BgfxRenderQueue.execute(() -> BGFX.bgfx_destroy_texture(handle));
                     break;
                 case "texture_view":
                     // LWJGL BGFX bindings don't have bgfx_destroy_texture_view
@@ -0,0 +1,257 @@
+package com.vitra.render.bgfx;
+
+import org.lwjgl.system.MemoryUtil;
+
+import java.nio.ByteOrder;
+
+/**
+ * Pixel format conversion kernels for texture uploads, working on native memory.
+ *
+ * Each kernel processes whole 64-bit words (two RGBA8 pixels, or four source pixels for RGB8 and A8)
+ * with shifts and masks instead of moving single bytes through a ByteBuffer, then finishes the tail
+ * pixel by pixel. Word reads and writes go through MemoryUtil, so no bounds checks or buffer
+ * positions are involved; callers pass valid addresses and pixel counts. Source and destination may
+ * be the same for the 32-bit to 32-bit kernels.
+ *
+ * The word paths assume a little-endian host; on big-endian hosts every kernel takes the scalar path.
+ *
+ * Byte orders are named in memory order: RGBA8 is R, G, B, A at increasing addresses (what
+ * BGFX_TEXTURE_FORMAT_RGBA8 and NativeImage's RGBA format hold).
+ */
+public final class BgfxPixelKernels {
+    private static final boolean WORD_PATH = ByteOrder.nativeOrder() == ByteOrder.LITTLE_ENDIAN;
+
+    private static final int OPAQUE = 0xFF000000;
+
+    /**
+     * RGB8 to RGBA8 with alpha 255.
+     */
+    public static void rgb8ToRgba8(long src, long dst, int pixels) {
+        int i = 0;
+        if (WORD_PATH) {
+            // Four pixels: 12 source bytes in three words -> 16 destination bytes in two words
+            for (; i + 4 <= pixels; i += 4) {
+                long in = src + i * 3L;
+                int w0 = MemoryUtil.memGetInt(in);
+                int w1 = MemoryUtil.memGetInt(in + 4);
+                int w2 = MemoryUtil.memGetInt(in + 8);
+                int p0 = w0 | OPAQUE;
+                int p1 = (w0 >>> 24 | w1 << 8) | OPAQUE;
+                int p2 = (w1 >>> 16 | w2 << 16) | OPAQUE;
+                int p3 = w2 >>> 8 | OPAQUE;
+                long out = dst + i * 4L;
+                MemoryUtil.memPutLong(out, pack(p0, p1));
+                MemoryUtil.memPutLong(out + 8, pack(p2, p3));
+            }
+        }
+        for (; i < pixels; i++) {
+            long in = src + i * 3L;
+            long out = dst + i * 4L;
+            MemoryUtil.memPutByte(out, MemoryUtil.memGetByte(in));
+            MemoryUtil.memPutByte(out + 1, MemoryUtil.memGetByte(in + 1));
+            MemoryUtil.memPutByte(out + 2, MemoryUtil.memGetByte(in + 2));
+            MemoryUtil.memPutByte(out + 3, (byte) 0xFF);
+        }
+    }
+
+    /**
+     * BGRA8 to RGBA8 (swap R and B). The conversion is its own inverse, so it also converts RGBA8 to BGRA8.
+     */
+    public static void swapRedBlue(long src, long dst, int pixels) {
+        int i = 0;
+        if (WORD_PATH) {
+            for (; i + 2 <= pixels; i += 2) {
+                long x = MemoryUtil.memGetLong(src + i * 4L);
+                x = (x & 0xFF00FF00FF00FF00L) | (x & 0x000000FF000000FFL) << 16 | (x >>> 16 & 0x000000FF000000FFL);
+                MemoryUtil.memPutLong(dst + i * 4L, x);
+            }
+        }
+        for (; i < pixels; i++) {
+            long in = src + i * 4L;
+            long out = dst + i * 4L;
+            byte b = MemoryUtil.memGetByte(in);
+            byte g = MemoryUtil.memGetByte(in + 1);
+            byte r = MemoryUtil.memGetByte(in + 2);
+            byte a = MemoryUtil.memGetByte(in + 3);
+            MemoryUtil.memPutByte(out, r);
+            MemoryUtil.memPutByte(out + 1, g);
+            MemoryUtil.memPutByte(out + 2, b);
+            MemoryUtil.memPutByte(out + 3, a);
+        }
+    }
+
+    /**
+     * ABGR8 to RGBA8 (reverse the bytes of every pixel). Its own inverse, so it also converts RGBA8 to ABGR8.
+     */
+    public static void reversePixelBytes(long src, long dst, int pixels) {
+        int i = 0;
+        if (WORD_PATH) {
+            for (; i + 2 <= pixels; i += 2) {
+                // Reversing the word reverses each pixel's bytes and swaps the pixels; rotating swaps them back
+                long x = MemoryUtil.memGetLong(src + i * 4L);
+                MemoryUtil.memPutLong(dst + i * 4L, Long.rotateLeft(Long.reverseBytes(x), 32));
+            }
+        }
+        for (; i < pixels; i++) {
+            long in = src + i * 4L;
+            long out = dst + i * 4L;
+            byte c0 = MemoryUtil.memGetByte(in);
+            byte c1 = MemoryUtil.memGetByte(in + 1);
+            byte c2 = MemoryUtil.memGetByte(in + 2);
+            byte c3 = MemoryUtil.memGetByte(in + 3);
+            MemoryUtil.memPutByte(out, c3);
+            MemoryUtil.memPutByte(out + 1, c2);
+            MemoryUtil.memPutByte(out + 2, c1);
+            MemoryUtil.memPutByte(out + 3, c0);
+        }
+    }
+
+    /**
+     * A8 to RGBA8 with black color channels, as GL_ALPHA textures sample.
+     */
+    public static void a8ToRgba8(long src, long dst, int pixels) {
+        int i = 0;
+        if (WORD_PATH) {
+            for (; i + 4 <= pixels; i += 4) {
+                int w = MemoryUtil.memGetInt(src + i);
+                long out = dst + i * 4L;
+                MemoryUtil.memPutLong(out, pack(w << 24, (w & 0xFF00) << 16));
+                MemoryUtil.memPutLong(out + 8, pack((w & 0xFF0000) << 8, w & 0xFF000000));
+            }
+        }
+        for (; i < pixels; i++) {
+            long out = dst + i * 4L;
+            MemoryUtil.memPutInt(out, 0);
+            MemoryUtil.memPutByte(out + 3, MemoryUtil.memGetByte(src + i));
+        }
+    }
+
+    /**
+     * Fill count 32-bit values with value (in native byte order).
+     */
+    public static void fill32(long dst, int value, int count) {
+        int i = 0;
+        long pair = pack(value, value);
+        for (; i + 2 <= count; i += 2) {
+            MemoryUtil.memPutLong(dst + i * 4L, pair);
+        }
+        if (i < count) {
+            MemoryUtil.memPutInt(dst + i * 4L, value);
+        }
+    }
+
+    /**
+     * One row of a 2x2 box downsample of RGBA8. Output pixel i averages the pixels at 2i and 2i + 1
+     * (pixelStep bytes apart; 0 when the source is one pixel wide) of source rows row0 and row1.
+     *
+     * Colors are weighted by alpha, so transparent texels do not darken the edges of their neighbours.
+     * Blocks of four cutout texels (alpha 0 or 255 only, as leaves and grass) stay cutout: opaque when at
+     * least two texels are, transparent otherwise, so foliage does not fade away with distance. Fully
+     * opaque blocks, the common case, are averaged one word per row.
+     */
+    public static void downsampleRgba8(long row0, long row1, long dst, int pixels, int pixelStep) {
+        for (int i = 0; i < pixels; i++) {
+            long in0 = row0 + i * 8L;
+            long in1 = row1 + i * 8L;
+            int p0 = MemoryUtil.memGetInt(in0);
+            int p1 = MemoryUtil.memGetInt(in0 + pixelStep);
+            int p2 = MemoryUtil.memGetInt(in1);
+            int p3 = MemoryUtil.memGetInt(in1 + pixelStep);
+            int out;
+            if (WORD_PATH && (p0 & p1 & p2 & p3) >>> 24 == 0xFF) {
+                // Channels widened to 16-bit lanes, summed four at a time, rounded and narrowed back
+                long sum = widen(p0) + widen(p1) + widen(p2) + widen(p3) + 0x0002000200020002L;
+                out = narrow(sum >>> 2 & 0x00FF00FF00FF00FFL);
+            } else {
+                out = averageWeighted(p0, p1, p2, p3);
+            }
+            MemoryUtil.memPutInt(dst + i * 4L, out);
+        }
+    }
+
+    /**
+     * One row of a 2x2 box downsample of R8, with the layout of {@link #downsampleRgba8}.
+     */
+    public static void downsampleR8(long row0, long row1, long dst, int pixels, int pixelStep) {
+        int i = 0;
+        if (WORD_PATH && pixelStep == 1) {
+            // Four outputs: 8 bytes of each row, adjacent pairs summed in 16-bit lanes
+            for (; i + 4 <= pixels; i += 4) {
+                long a = MemoryUtil.memGetLong(row0 + i * 2L);
+                long b = MemoryUtil.memGetLong(row1 + i * 2L);
+                long sum = (a & 0x00FF00FF00FF00FFL) + (a >>> 8 & 0x00FF00FF00FF00FFL)
+                    + (b & 0x00FF00FF00FF00FFL) + (b >>> 8 & 0x00FF00FF00FF00FFL) + 0x0002000200020002L;
+                MemoryUtil.memPutInt(dst + i, narrow(sum >>> 2 & 0x00FF00FF00FF00FFL));
+            }
+        }
+        for (; i < pixels; i++) {
+            long in0 = row0 + i * 2L;
+            long in1 = row1 + i * 2L;
+            int sum = (MemoryUtil.memGetByte(in0) & 0xFF) + (MemoryUtil.memGetByte(in0 + pixelStep) & 0xFF)
+                + (MemoryUtil.memGetByte(in1) & 0xFF) + (MemoryUtil.memGetByte(in1 + pixelStep) & 0xFF);
+            MemoryUtil.memPutByte(dst + i, (byte) ((sum + 2) >> 2));
+        }
+    }
+
+    /**
+     * Alpha-weighted average of four RGBA8 pixels (as read from memory on a little-endian host:
+     * R in the low byte), keeping cutout blocks cutout.
+     */
+    private static int averageWeighted(int p0, int p1, int p2, int p3) {
+        int a0 = p0 >>> 24;
+        int a1 = p1 >>> 24;
+        int a2 = p2 >>> 24;
+        int a3 = p3 >>> 24;
+        int alphaSum = a0 + a1 + a2 + a3;
+
+        int alpha;
+        if (isCutout(a0) && isCutout(a1) && isCutout(a2) && isCutout(a3)) {
+            alpha = alphaSum >= 2 * 255 ? 255 : 0;
+        } else {
+            alpha = (alphaSum + 2) >> 2;
+        }
+
+        int out = alpha << 24;
+        for (int shift = 0; shift < 24; shift += 8) {
+            int c0 = p0 >>> shift & 0xFF;
+            int c1 = p1 >>> shift & 0xFF;
+            int c2 = p2 >>> shift & 0xFF;
+            int c3 = p3 >>> shift & 0xFF;
+            int c = alphaSum == 0
+                ? (c0 + c1 + c2 + c3 + 2) >> 2
+                : (c0 * a0 + c1 * a1 + c2 * a2 + c3 * a3 + alphaSum / 2) / alphaSum;
+            out |= c << shift;
+        }
+        return out;
+    }
+
+    private static boolean isCutout(int alpha) {
+        return alpha == 0 || alpha == 255;
+    }
+
+    /**
+     * The four bytes of an int in the four 16-bit lanes of a word, lowest byte in the lowest lane.
+     */
+    private static long widen(int value) {
+        long v = value & 0xFFFFFFFFL;
+        return (v & 0xFFL) | (v & 0xFF00L) << 8 | (v & 0xFF0000L) << 16 | (v & 0xFF000000L) << 24;
+    }
+
+    /**
+     * Inverse of {@link #widen}: the low bytes of the four 16-bit lanes as one int.
+     */
+    private static int narrow(long lanes) {
+        lanes = (lanes | lanes >>> 8) & 0x0000FFFF0000FFFFL;
+        return (int) (lanes | lanes >>> 16);
+    }
+
+    /**
+     * Two 32-bit pixels as one word, first pixel at the lower address (little-endian).
+     */
+    private static long pack(int first, int second) {
+        return (first & 0xFFFFFFFFL) | (long) second << 32;
+    }
+
+    private BgfxPixelKernels() {
+    }
+}
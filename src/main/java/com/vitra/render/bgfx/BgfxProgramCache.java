@@ -0,0 +1,160 @@
+package com.vitra.render.bgfx;
+
+import com.mojang.blaze3d.pipeline.RenderPipeline;
+import com.mojang.blaze3d.shaders.ShaderDefines;
+import net.minecraft.resources.ResourceLocation;
+import org.lwjgl.bgfx.BGFX;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+import java.util.HashMap;
+import java.util.Map;
+
+/**
+ * Reference-counted cache of BGFX programs shared across render pipelines.
+ *
+ * A pipeline's vertex and fragment shader locations plus its shader defines are resolved once to the
+ * precompiled vs_* / fs_* binaries bundled in /shaders ("minecraft:core/rendertype_text" ->
+ * vs_rendertype_text / fs_rendertype_text). Pipelines without bundled binaries fall back to the
+ * "basic" pair. Every distinct binary pair is loaded into one program, shared by all pipelines that
+ * resolve to it, and destroyed when the last of them releases it.
+ *
+ * The binaries are compiled ahead of time without define variants, so pipelines that differ only
+ * in defines share a program.
+ *
+ * Thread-safe.
+ *
+ * Uses: bgfx_create_shader(), bgfx_create_program(), bgfx_destroy_program()
+ */
+public final class BgfxProgramCache {
+    private static final Logger LOGGER = LoggerFactory.getLogger("BgfxProgramCache");
+
+    public static final String DEFAULT_SHADER = "basic";
+
+    private record ProgramKey(ResourceLocation vertex, ResourceLocation fragment, ShaderDefines defines) {
+    }
+
+    private record Binaries(String vertex, String fragment) {
+    }
+
+    private static final class Entry {
+        final short handle;
+        int refs;
+
+        Entry(short handle) {
+            this.handle = handle;
+        }
+    }
+
+    private static final Map<ProgramKey, Binaries> resolved = new HashMap<>();
+    private static final Map<Binaries, Entry> programs = new HashMap<>();
+    private static final Map<Short, Binaries> byHandle = new HashMap<>();
+
+    /**
+     * Program for a pipeline's shaders, loading it on first use. Pair with {@link #release(short)}.
+     *
+     * @return Program handle, or BGFX_INVALID_HANDLE if it could not be created
+     */
+    public static synchronized short acquire(RenderPipeline pipeline) {
+        ProgramKey key = new ProgramKey(pipeline.getVertexShader(), pipeline.getFragmentShader(), pipeline.getShaderDefines());
+        return acquire(resolved.computeIfAbsent(key, BgfxProgramCache::resolve));
+    }
+
+    /**
+     * Program built from vs_{name} / fs_{name}, loading it on first use. Pair with {@link #release(short)}.
+     */
+    public static synchronized short acquire(String shaderName) {
+        return acquire(new Binaries("vs_" + shaderName, "fs_" + shaderName));
+    }
+
+    private static short acquire(Binaries binaries) {
+        Entry entry = programs.get(binaries);
+        if (entry == null) {
+            short vertexShader = Util.loadShader(binaries.vertex());
+            short fragmentShader = Util.loadShader(binaries.fragment());
+            if (!Util.isValidHandle(vertexShader) || !Util.isValidHandle(fragmentShader)) {
+                LOGGER.error("Failed to load shaders {} / {}", binaries.vertex(), binaries.fragment());
+                if (Util.isValidHandle(vertexShader)) {
+                    BGFX.bgfx_destroy_shader(vertexShader);
+                }
+                if (Util.isValidHandle(fragmentShader)) {
+                    BGFX.bgfx_destroy_shader(fragmentShader);
+                }
+                return BGFX.BGFX_INVALID_HANDLE;
+            }
+
+            short handle = Util.createProgram(vertexShader, fragmentShader, true);
+            if (!Util.isValidHandle(handle)) {
+                return BGFX.BGFX_INVALID_HANDLE;
+            }
+            entry = new Entry(handle);
+            programs.put(binaries, entry);
+            byHandle.put(handle, binaries);
+            LOGGER.debug("Created program {} from {} / {}", handle, binaries.vertex(), binaries.fragment());
+        }
+        entry.refs++;
+        return entry.handle;
+    }
+
+    /**
+     * Drop one reference to a program; the last reference destroys it.
+     */
+    public static synchronized void release(short handle) {
+        Binaries binaries = byHandle.get(handle);
+        if (binaries == null) {
+            return;
+        }
+        Entry entry = programs.get(binaries);
+        if (--entry.refs == 0) {
+            BGFX.bgfx_destroy_program(handle);
+            programs.remove(binaries);
+            byHandle.remove(handle);
+            LOGGER.debug("Destroyed program {} ({} / {})", handle, binaries.vertex(), binaries.fragment());
+        }
+    }
+
+    /**
+     * Binaries for a pipeline's shaders: the bundled pair named after the shader locations, or the default pair.
+     */
+    private static Binaries resolve(ProgramKey key) {
+        String vertex = "vs_" + shaderName(key.vertex());
+        String fragment = "fs_" + shaderName(key.fragment());
+        if (hasBinary(vertex) && hasBinary(fragment)) {
+            return new Binaries(vertex, fragment);
+        }
+        LOGGER.debug("No bundled binaries for {} / {}, using {}", key.vertex(), key.fragment(), DEFAULT_SHADER);
+        return new Binaries("vs_" + DEFAULT_SHADER, "fs_" + DEFAULT_SHADER);
+    }
+
+    private static String shaderName(ResourceLocation location) {
+        String path = location.getPath();
+        return path.substring(path.lastIndexOf('/') + 1);
+    }
+
+    private static boolean hasBinary(String name) {
+        return BgfxProgramCache.class.getResource("/shaders/" + name + ".bin") != null;
+    }
+
+    /**
+     * Number of live programs, for logs and debug overlays.
+     */
+    public static synchronized int getProgramCount() {
+        return programs.size();
+    }
+
+    /**
+     * Destroy all programs regardless of references. Called on renderer shutdown.
+     */
+    public static synchronized void shutdown() {
+        for (Entry entry : programs.values()) {
+            BGFX.bgfx_destroy_program(entry.handle);
+        }
+        LOGGER.info("Program cache shutdown complete ({} programs destroyed)", programs.size());
+        programs.clear();
+        byHandle.clear();
+        resolved.clear();
+    }
+
+    private BgfxProgramCache() {
+    }
+}
@@ -0,0 +1,119 @@
+package com.vitra.render.bgfx;
+
+import com.mojang.blaze3d.systems.RenderSystem;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.concurrent.atomic.AtomicInteger;
+
+/**
+ * Multi-producer, single-consumer queue of BGFX resource commands (texture and buffer creation,
+ * uploads, destruction) for threads other than the render thread.
+ *
+ * BGFX's non-encoder API may only be called from the render thread. Resource reload, font loading
+ * and chunk builders stage their data in native memory first (a BgfxUploadPool block or bgfx_copy(),
+ * both safe on any thread) and enqueue the BGFX call with {@link #execute(Command)}. The render
+ * thread runs queued commands in {@link #drain()} right before bgfx_frame(), stopping once the
+ * frame's time budget is spent; what is left runs in the next frame. Producers never wait.
+ *
+ * Commands run in submission order. On the render thread a command runs immediately, after every
+ * command still queued ahead of it (regardless of the frame budget), so a resource created or updated
+ * on the render thread is ready as soon as the call returns and is never used before the commands
+ * queued for it by other threads.
+ *
+ * Uses: nothing directly; commands call BGFX on the render thread
+ */
+public final class BgfxRenderQueue {
+    private static final Logger LOGGER = LoggerFactory.getLogger("BgfxRenderQueue");
+
+    // Render thread time spent on queued commands per frame; at least one command always runs
+    private static final long FRAME_BUDGET_NANOS = 2_000_000L;
+
+    /**
+     * A BGFX call to run on the render thread, with its data already staged.
+     */
+    @FunctionalInterface
+    public interface Command {
+        void run();
+
+        /**
+         * Release staged data of a command that will never run. Called on shutdown.
+         */
+        default void discard() {
+        }
+    }
+
+    private static final ConcurrentLinkedQueue<Command> pending = new ConcurrentLinkedQueue<>();
+    // Kept separately: ConcurrentLinkedQueue.size() walks the queue
+    private static final AtomicInteger pendingCount = new AtomicInteger();
+
+    /**
+     * Run a command on the render thread: now if called there (after the commands queued ahead of it),
+     * otherwise at the next {@link #drain()}.
+     */
+    public static void execute(Command command) {
+        if (RenderSystem.isOnRenderThread()) {
+            runQueued(Long.MAX_VALUE);
+            command.run();
+            return;
+        }
+        pendingCount.incrementAndGet();
+        pending.add(command);
+    }
+
+    /**
+     * Run queued commands until the frame budget is spent. Render thread only; called before bgfx_frame().
+     *
+     * @return Number of commands run
+     */
+    public static int drain() {
+        int executed = runQueued(System.nanoTime() + FRAME_BUDGET_NANOS);
+        if (executed > 0) {
+            LOGGER.trace("Ran {} queued render commands, {} left", executed, pendingCount.get());
+        }
+        return executed;
+    }
+
+    private static int runQueued(long deadline) {
+        int executed = 0;
+        Command command;
+        while ((command = pending.poll()) != null) {
+            pendingCount.decrementAndGet();
+            try {
+                command.run();
+            } catch (Exception e) {
+                LOGGER.error("Queued render command failed", e);
+            }
+            executed++;
+            if (deadline != Long.MAX_VALUE && System.nanoTime() >= deadline) {
+                break;
+            }
+        }
+        return executed;
+    }
+
+    /**
+     * Number of commands waiting for the render thread.
+     */
+    public static int getPendingCount() {
+        return pendingCount.get();
+    }
+
+    /**
+     * Drop commands that have not run. Called on renderer shutdown.
+     */
+    public static void shutdown() {
+        int discarded = 0;
+        Command command;
+        while ((command = pending.poll()) != null) {
+            pendingCount.decrementAndGet();
+            command.discard();
+            discarded++;
+        }
+        LOGGER.info("Render queue shutdown complete ({} pending commands discarded)", discarded);
+    }
+
+    private BgfxRenderQueue() {
+    }
+}
@@ -0,0 +1,69 @@
+package com.vitra.render.bgfx;
+
+import org.lwjgl.bgfx.BGFX;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+import java.util.Map;
+import java.util.concurrent.ConcurrentHashMap;
+
+/**
+ * Per-draw scissor rectangles through BGFX's frame rect cache.
+ *
+ * A view scissor (bgfx_set_view_scissor) clips every draw of the view, so a GUI scroll area would
+ * clip everything drawn after it in the same pass. Scissors are set per draw instead. The first draw
+ * with a rectangle in a frame registers it with bgfx_encoder_set_scissor, which returns its cache
+ * index; later draws with the same rectangle only pass the index to bgfx_encoder_set_scissor_cached.
+ * The cache belongs to the frame, so indices are valid on every encoder and are dropped in
+ * {@link #endFrame()}.
+ *
+ * Thread-safe.
+ *
+ * Uses: bgfx_encoder_set_scissor(), bgfx_encoder_set_scissor_cached()
+ */
+public final class BgfxScissors {
+    private static final Logger LOGGER = LoggerFactory.getLogger("BgfxScissors");
+
+    // BGFX_CONFIG_MAX_RECT_CACHE
+    private static final int MAX_CACHED_RECTS = 4096;
+
+    private record Rect(int x, int y, int width, int height) {
+    }
+
+    private static final Map<Rect, Short> cacheIndices = new ConcurrentHashMap<>();
+
+    /**
+     * Scissor the next submit on an encoder to a rectangle (top-left origin, in pixels of the view's target).
+     */
+    public static void apply(long encoder, int x, int y, int width, int height) {
+        Rect rect = new Rect(x, y, width, height);
+        Short cached = cacheIndices.get(rect);
+        if (cached != null) {
+            BGFX.bgfx_encoder_set_scissor_cached(encoder, cached & 0xFFFF);
+            return;
+        }
+
+        short index = BGFX.bgfx_encoder_set_scissor(encoder, x, y, width, height);
+        if (cacheIndices.size() < MAX_CACHED_RECTS) {
+            cacheIndices.putIfAbsent(rect, index);
+        }
+        LOGGER.trace("Registered scissor {},{} {}x{} -> cache index {}", x, y, width, height, index & 0xFFFF);
+    }
+
+    /**
+     * Number of distinct scissor rectangles registered this frame.
+     */
+    public static int getCachedCount() {
+        return cacheIndices.size();
+    }
+
+    /**
+     * Forget this frame's cache indices. Called after bgfx_frame().
+     */
+    public static void endFrame() {
+        cacheIndices.clear();
+    }
+
+    private BgfxScissors() {
+    }
+}
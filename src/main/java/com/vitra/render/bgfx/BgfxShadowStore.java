@@ -0,0 +1,80 @@
+package com.vitra.render.bgfx;
+
+import org.lwjgl.system.MemoryUtil;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.concurrent.atomic.AtomicLong;
+
+/**
+ * Budgeted native memory for CPU-side shadow copies of BgfxBuffers.
+ *
+ * BGFX has no buffer readback and no buffer-to-buffer or buffer-to-texture copy, so buffers created
+ * with GpuBuffer.USAGE_COPY_SRC keep a CPU copy of their contents. BgfxCommandEncoder serves copies
+ * out of that copy with a single bgfx update, with no GPU readback and no stall.
+ *
+ * Shadows count against MAX_SHADOW_BYTES. A buffer that does not fit gets no shadow, and copies
+ * from it are skipped with a warning instead of uploading garbage. Thread-safe.
+ */
+public final class BgfxShadowStore {
+    private static final Logger LOGGER = LoggerFactory.getLogger("BgfxShadowStore");
+
+    // Upper bound for all shadow copies together
+    private static final long MAX_SHADOW_BYTES = 64L * 1024 * 1024;
+
+    private static final AtomicLong usedBytes = new AtomicLong();
+    private static final AtomicLong peakBytes = new AtomicLong();
+    private static final AtomicLong shadowCount = new AtomicLong();
+    private static final AtomicLong rejectedCount = new AtomicLong();
+
+    /**
+     * Allocate a zeroed shadow of {@code size} bytes, or null if it would exceed the budget.
+     */
+    public static ByteBuffer allocate(String name, int size) {
+        long used;
+        do {
+            used = usedBytes.get();
+            if (used + size > MAX_SHADOW_BYTES) {
+                rejectedCount.incrementAndGet();
+                LOGGER.warn("Shadow budget exhausted ({} / {} bytes): no CPU copy for {} ({} bytes)",
+                    used, MAX_SHADOW_BYTES, name, size);
+                return null;
+            }
+        } while (!usedBytes.compareAndSet(used, used + size));
+
+        peakBytes.accumulateAndGet(used + size, Math::max);
+        shadowCount.incrementAndGet();
+        return MemoryUtil.memCalloc(size).order(ByteOrder.nativeOrder());
+    }
+
+    /**
+     * Free a shadow returned by {@link #allocate(String, int)}.
+     */
+    public static void free(ByteBuffer shadow) {
+        usedBytes.addAndGet(-shadow.capacity());
+        shadowCount.decrementAndGet();
+        MemoryUtil.memFree(shadow);
+    }
+
+    public static long getUsedBytes() {
+        return usedBytes.get();
+    }
+
+    public static long getPeakBytes() {
+        return peakBytes.get();
+    }
+
+    /**
+     * Summary of shadow memory use, for logs and debug overlays.
+     */
+    public static String getStats() {
+        return String.format("shadows=%d used=%d KB peak=%d KB budget=%d KB rejected=%d",
+            shadowCount.get(), usedBytes.get() / 1024, peakBytes.get() / 1024,
+            MAX_SHADOW_BYTES / 1024, rejectedCount.get());
+    }
+
+    private BgfxShadowStore() {
+    }
+}
@@ -0,0 +1,214 @@
+package com.vitra.render.bgfx;
+
+import com.mojang.blaze3d.vertex.VertexFormat;
+import org.lwjgl.bgfx.BGFX;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+/**
+ * Shared, grow-on-demand index buffers for Minecraft's generated index patterns.
+ *
+ * QUADS (0,1,2,2,3,0), LINES (0,1,2,3,2,1), TRIANGLE_FAN and plain sequential draws all use the
+ * same indices for a given vertex count, so instead of every MeshData or
+ * RenderSystem.AutoStorageIndexBuffer uploading its own copy, each pattern lives in one static
+ * BGFX index buffer that every draw references. Each pattern has a 16-bit variant, used for draws
+ * of up to 65,536 vertices, and a 32-bit variant for anything larger.
+ *
+ * Buffers grow in powers of two. A replaced buffer is retired through BgfxBufferLifetime, so
+ * draws already submitted this frame keep a valid handle. Must only be used from the render thread.
+ *
+ * Uses: bgfx_create_index_buffer()
+ */
+public final class BgfxSharedIndexBuffers {
+    private static final Logger LOGGER = LoggerFactory.getLogger("BgfxSharedIndexBuffers");
+
+    // Largest vertex count addressable with 16-bit indices
+    public static final int MAX_16BIT_VERTICES = 65536;
+
+    // Vertices covered by a freshly created buffer
+    private static final int MIN_VERTICES = 4096;
+
+    /**
+     * Index pattern generated for a primitive mode.
+     */
+    public enum Pattern {
+        SEQUENTIAL,
+        QUADS,
+        LINES,
+        TRIANGLE_FAN;
+
+        /**
+         * Number of indices needed to draw numVertices vertices.
+         */
+        public int indexCount(int numVertices) {
+            return switch (this) {
+                case SEQUENTIAL -> numVertices;
+                case QUADS, LINES -> numVertices / 4 * 6;
+                case TRIANGLE_FAN -> Math.max(numVertices - 2, 0) * 3;
+            };
+        }
+
+        /**
+         * Number of vertices referenced by the first numIndices indices.
+         */
+        public int vertexCount(int numIndices) {
+            return switch (this) {
+                case SEQUENTIAL -> numIndices;
+                case QUADS, LINES -> (numIndices + 5) / 6 * 4;
+                case TRIANGLE_FAN -> numIndices > 0 ? (numIndices + 2) / 3 + 2 : 0;
+            };
+        }
+
+        private void write(ByteBuffer data, int numVertices, boolean index32) {
+            switch (this) {
+                case SEQUENTIAL -> {
+                    for (int i = 0; i < numVertices; i++) {
+                        put(data, i, index32);
+                    }
+                }
+                case QUADS -> {
+                    for (int i = 0; i + 3 < numVertices; i += 4) {
+                        put(data, i, index32);
+                        put(data, i + 1, index32);
+                        put(data, i + 2, index32);
+                        put(data, i + 2, index32);
+                        put(data, i + 3, index32);
+                        put(data, i, index32);
+                    }
+                }
+                case LINES -> {
+                    // Minecraft expands each line segment into a 4-vertex quad
+                    for (int i = 0; i + 3 < numVertices; i += 4) {
+                        put(data, i, index32);
+                        put(data, i + 1, index32);
+                        put(data, i + 2, index32);
+                        put(data, i + 3, index32);
+                        put(data, i + 2, index32);
+                        put(data, i + 1, index32);
+                    }
+                }
+                case TRIANGLE_FAN -> {
+                    // BGFX has no fan primitive: expand to a triangle list around vertex 0
+                    for (int i = 1; i + 1 < numVertices; i++) {
+                        put(data, 0, index32);
+                        put(data, i, index32);
+                        put(data, i + 1, index32);
+                    }
+                }
+            }
+        }
+
+        private static void put(ByteBuffer data, int index, boolean index32) {
+            if (index32) {
+                data.putInt(index);
+            } else {
+                data.putShort((short) index);
+            }
+        }
+    }
+
+    /**
+     * One shared buffer and the GpuBuffer view handed to Minecraft.
+     */
+    private record Shared(short handle, int numVertices, BgfxBuffer buffer) {
+    }
+
+    // Indexed by pattern ordinal * 2 + (index32 ? 1 : 0)
+    private static final Shared[] buffers = new Shared[Pattern.values().length * 2];
+
+    /**
+     * Pattern that replaces per-mesh indices for a primitive mode, or null if the mode needs none.
+     */
+    public static Pattern pattern(VertexFormat.Mode mode) {
+        return switch (mode) {
+            case QUADS -> Pattern.QUADS;
+            case LINES -> Pattern.LINES;
+            case TRIANGLE_FAN -> Pattern.TRIANGLE_FAN;
+            default -> null;
+        };
+    }
+
+    /**
+     * Whether draws of numVertices vertices can use 16-bit indices.
+     */
+    public static boolean is16Bit(int numVertices) {
+        return numVertices <= MAX_16BIT_VERTICES;
+    }
+
+    /**
+     * Get the shared index buffer handle covering numVertices vertices of the pattern,
+     * or BGFX_INVALID_HANDLE if it could not be created.
+     */
+    public static short getHandle(Pattern pattern, int numVertices) {
+        Shared shared = ensure(pattern, numVertices);
+        return shared != null ? shared.handle() : BGFX.BGFX_INVALID_HANDLE;
+    }
+
+    /**
+     * Get the shared index buffer covering numVertices vertices as a GpuBuffer, for
+     * RenderSystem.AutoStorageIndexBuffer. The buffer is owned here: closing it does nothing.
+     */
+    public static BgfxBuffer getBuffer(Pattern pattern, int numVertices) {
+        Shared shared = ensure(pattern, numVertices);
+        return shared != null ? shared.buffer() : null;
+    }
+
+    private static Shared ensure(Pattern pattern, int numVertices) {
+        boolean index32 = !is16Bit(numVertices);
+        int slot = pattern.ordinal() * 2 + (index32 ? 1 : 0);
+
+        Shared shared = buffers[slot];
+        if (shared != null && shared.numVertices() >= numVertices) {
+            return shared;
+        }
+
+        // Grow in powers of two; the 16-bit variant never needs more than MAX_16BIT_VERTICES
+        int capacity = Math.max(MIN_VERTICES, Integer.highestOneBit(Math.max(numVertices - 1, 1)) << 1);
+        if (!index32) {
+            capacity = Math.min(capacity, MAX_16BIT_VERTICES);
+        }
+
+        int numIndices = pattern.indexCount(capacity);
+        ByteBuffer data = BgfxUploadPool.acquire(numIndices * (index32 ? 4 : 2)).order(ByteOrder.nativeOrder());
+        pattern.write(data, capacity, index32);
+        data.flip();
+
+        short handle = BgfxOperations.createIndexBuffer(BgfxUploadPool.submit(data),
+            index32 ? BGFX.BGFX_BUFFER_INDEX32 : BGFX.BGFX_BUFFER_NONE);
+        if (!Util.isValidHandle(handle)) {
+            LOGGER.error("Failed to create shared {} index buffer for {} vertices", pattern, capacity);
+            return null;
+        }
+
+        if (shared != null) {
+            BgfxBufferLifetime.retire(shared.handle(), Util.RESOURCE_INDEX_BUFFER);
+        }
+        BgfxBufferLifetime.track(handle, Util.RESOURCE_INDEX_BUFFER);
+
+        String name = "Shared " + pattern + (index32 ? " index32" : " index16");
+        shared = new Shared(handle, capacity, new BgfxBuffer(name, handle, numIndices, index32));
+        buffers[slot] = shared;
+
+        LOGGER.debug("Created {}: handle={}, vertices={}, indices={}", name, handle, capacity, numIndices);
+        return shared;
+    }
+
+    /**
+     * Retire all shared buffers. Called on renderer shutdown, before BgfxBufferLifetime.flush().
+     */
+    public static void shutdown() {
+        for (int i = 0; i < buffers.length; i++) {
+            if (buffers[i] != null) {
+                BgfxBufferLifetime.retire(buffers[i].handle(), Util.RESOURCE_INDEX_BUFFER);
+                buffers[i] = null;
+            }
+        }
+        LOGGER.info("Shared index buffers shutdown complete");
+    }
+
+    private BgfxSharedIndexBuffers() {
+    }
+}
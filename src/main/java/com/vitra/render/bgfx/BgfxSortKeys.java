@@ -0,0 +1,149 @@
+package com.vitra.render.bgfx;
+
+import com.mojang.blaze3d.pipeline.RenderPipeline;
+import com.mojang.blaze3d.platform.DepthTestFunction;
+import org.lwjgl.bgfx.BGFX;
+import org.lwjgl.bgfx.BGFXStats;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+import java.util.Arrays;
+
+/**
+ * Sort keys for bgfx_submit() and the matching per-view sort modes.
+ *
+ * BGFX sorts each view by a key built from the submit depth argument and, depending on the view
+ * mode, the program:
+ * - OPAQUE draws go to BGFX_VIEW_MODE_DEFAULT (program first) with a depth built from render state
+ *   and texture, so draws sharing program, state and texture end up adjacent
+ * - TRANSLUCENT draws go to BGFX_VIEW_MODE_DEPTH_DESCENDING with the squared camera distance, so
+ *   they are drawn back to front
+ * - everything else (GUI, overlays, post effects) keeps submission order (BGFX_VIEW_MODE_SEQUENTIAL)
+ *
+ * A view's mode is the mode of every draw submitted to it in the frame. A view that receives draws
+ * of different kinds stays sequential, so sorting never reorders draws that depend on painter's order.
+ * Modes are pushed to BGFX in {@link #applyViewModes()} right before bgfx_frame().
+ *
+ * Uses: bgfx_set_view_mode(), bgfx_get_stats()
+ */
+public final class BgfxSortKeys {
+    private static final Logger LOGGER = LoggerFactory.getLogger("BgfxSortKeys");
+
+    private static final int MAX_VIEWS = 256;
+
+    public enum Mode {
+        SEQUENTIAL(BGFX.BGFX_VIEW_MODE_SEQUENTIAL),
+        OPAQUE(BGFX.BGFX_VIEW_MODE_DEFAULT),
+        TRANSLUCENT(BGFX.BGFX_VIEW_MODE_DEPTH_DESCENDING);
+
+        private final int viewMode;
+
+        Mode(int viewMode) {
+            this.viewMode = viewMode;
+        }
+    }
+
+    // Mode requested for each view this frame (null = no draws yet) and the mode last set on BGFX
+    // (null = BGFX's initial BGFX_VIEW_MODE_DEFAULT)
+    private static final Mode[] requested = new Mode[MAX_VIEWS];
+    private static final Mode[] applied = new Mode[MAX_VIEWS];
+    private static final int[] submitsThisFrame = new int[Mode.values().length];
+    private static String lastFrameStats = "";
+
+    /**
+     * Sort mode for draws of a pipeline.
+     */
+    public static Mode classify(RenderPipeline pipeline) {
+        if (pipeline.getDepthTestFunction() == DepthTestFunction.NO_DEPTH_TEST) {
+            return Mode.SEQUENTIAL;
+        }
+        if (pipeline.getBlendFunction().isPresent()) {
+            return Mode.TRANSLUCENT;
+        }
+        return pipeline.isWriteDepth() ? Mode.OPAQUE : Mode.SEQUENTIAL;
+    }
+
+    /**
+     * Sort mode for draws with the given BGFX render state.
+     */
+    public static Mode classify(long state) {
+        if ((state & BGFX.BGFX_STATE_DEPTH_TEST_MASK) == 0) {
+            return Mode.SEQUENTIAL;
+        }
+        if ((state & BGFX.BGFX_STATE_BLEND_MASK) != 0) {
+            return Mode.TRANSLUCENT;
+        }
+        return (state & BGFX.BGFX_STATE_WRITE_Z) != 0 ? Mode.OPAQUE : Mode.SEQUENTIAL;
+    }
+
+    /**
+     * Depth key grouping opaque draws by render state, then texture (BGFX adds the program above it).
+     */
+    public static int opaqueKey(long state, short texture) {
+        int stateHash = (int) (state ^ (state >>> 32));
+        stateHash ^= stateHash >>> 16;
+        return (stateHash & 0xFFFF) << 16 | (texture & 0xFFFF);
+    }
+
+    /**
+     * Depth key ordering translucent draws by squared camera distance (larger = drawn first).
+     */
+    public static int translucentKey(float distanceSq) {
+        // Bits of a non-negative float sort like the float itself
+        return Float.floatToRawIntBits(Math.max(distanceSq, 0.0f));
+    }
+
+    /**
+     * Depth key for a draw of the given mode.
+     */
+    public static int key(Mode mode, long state, short texture, float distanceSq) {
+        return switch (mode) {
+            case OPAQUE -> opaqueKey(state, texture);
+            case TRANSLUCENT -> translucentKey(distanceSq);
+            case SEQUENTIAL -> 0;
+        };
+    }
+
+    /**
+     * Record that a draw of the given mode is submitted to a view this frame.
+     */
+    public static synchronized void requestViewMode(int viewId, Mode mode) {
+        Mode current = requested[viewId];
+        requested[viewId] = current == null || current == mode ? mode : Mode.SEQUENTIAL;
+        submitsThisFrame[mode.ordinal()]++;
+    }
+
+    /**
+     * Push this frame's view modes to BGFX. Must be called right before bgfx_frame().
+     */
+    public static synchronized void applyViewModes() {
+        for (int viewId = 0; viewId < MAX_VIEWS; viewId++) {
+            Mode mode = requested[viewId];
+            if (mode == null) {
+                continue;
+            }
+            if (mode != applied[viewId] && !(applied[viewId] == null && mode == Mode.OPAQUE)) {
+                BGFX.bgfx_set_view_mode(viewId, mode.viewMode);
+                LOGGER.debug("View {} sort mode -> {}", viewId, mode);
+            }
+            applied[viewId] = mode;
+            requested[viewId] = null;
+        }
+
+        lastFrameStats = String.format("opaque=%d translucent=%d sequential=%d",
+            submitsThisFrame[Mode.OPAQUE.ordinal()], submitsThisFrame[Mode.TRANSLUCENT.ordinal()],
+            submitsThisFrame[Mode.SEQUENTIAL.ordinal()]);
+        Arrays.fill(submitsThisFrame, 0);
+    }
+
+    /**
+     * Submits per sort mode in the last frame, with BGFX's draw count for comparison.
+     */
+    public static synchronized String getStats() {
+        BGFXStats stats = BGFX.bgfx_get_stats();
+        return stats != null ? lastFrameStats + " bgfxDraws=" + stats.numDraw() : lastFrameStats;
+    }
+
+    private BgfxSortKeys() {
+    }
+}
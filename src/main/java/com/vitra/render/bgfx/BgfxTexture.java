@@ -1,8 +1,11 @@
 package com.vitra.render.bgfx;
 
+import com.mojang.blaze3d.platform.NativeImage;
 import com.mojang.blaze3d.textures.GpuTexture;
 import com.mojang.blaze3d.textures.TextureFormat;
 import org.lwjgl.bgfx.BGFX;
+import org.lwjgl.bgfx.BGFXMemory;
+import org.lwjgl.system.MemoryUtil;
 import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 
@@ -22,6 +25,11 @@ public class BgfxTexture extends GpuTexture {
     private final int textureHeight;   // Store height locally since parent field is private
     private boolean closed = false;
 
+    // CPU mip chain for textures uploaded without their mips (see BgfxMipmaps); disabled once the
+    // uploader writes a mip level itself, and for render targets, whose contents never pass through here
+    private BgfxMipmaps.Chain mipChain;
+    private boolean mipChainDisabled;
+
     /**
      * Create a 2D texture using BGFX native functionality.
      * BGFX handles all validation and creation internally.
@@ -34,10 +42,14 @@ public class BgfxTexture extends GpuTexture {
         this.bgfxFormat = convertTextureFormat(minecraftFormat);
 
         // Create the texture using BGFX - it handles all validation
+        // Render attachments must be created as render targets to back a BGFX framebuffer (see BgfxViews)
+        long flags = (usage & GpuTexture.USAGE_RENDER_ATTACHMENT) != 0 ? BGFX.BGFX_TEXTURE_RT : BGFX.BGFX_TEXTURE_NONE;
         this.bgfxHandle = BgfxOperations.createTexture2D(
-            width, height, mipLevels > 1, 1, bgfxFormat, 0
+            width, height, mipLevels > 1, 1, bgfxFormat, flags
         );
 
+        this.mipChainDisabled = mipLevels < 2 || (usage & GpuTexture.USAGE_RENDER_ATTACHMENT) != 0;
+
         LOGGER.debug("Created 2D texture: {} (handle: {}, {}x{}, format: {})",
             name, bgfxHandle, width, height, bgfxFormat);
     }
@@ -52,6 +64,7 @@ public class BgfxTexture extends GpuTexture {
         this.textureHeight = height;
         this.bgfxHandle = bgfxHandle;
         this.bgfxFormat = format;
+        this.mipChainDisabled = true;
     }
 
     private int convertTextureFormat(TextureFormat minecraftFormat) {
@@ -95,14 +108,87 @@ public class BgfxTexture extends GpuTexture {
         return bgfxFormat;
     }
 
+    /**
+     * Whether this is a depth (or depth/stencil) texture.
+     */
+    public boolean isDepthFormat() {
+        return bgfxFormat > BGFX.BGFX_TEXTURE_FORMAT_UNKNOWN_DEPTH && bgfxFormat < BGFX.BGFX_TEXTURE_FORMAT_COUNT;
+    }
+
     /**
      * Update texture data using BGFX native functionality.
      * BGFX handles all validation internally.
      */
     public boolean updateData(int mipLevel, int x, int y, int width, int height, ByteBuffer data) {
+        trackMipWrite(mipLevel, x, y, width, height, MemoryUtil.memAddress(data), data.remaining());
         return BgfxOperations.updateTexture2D(bgfxHandle, mipLevel, x, y, width, height, data);
     }
 
+    /**
+     * Update texture data from BGFX memory (zero-copy when it comes from BgfxUploadPool).
+     */
+    public boolean updateData(int mipLevel, int x, int y, int width, int height, BGFXMemory memory) {
+        trackMipWrite(mipLevel, x, y, width, height, MemoryUtil.memAddress(memory.data()), memory.size());
+        return BgfxOperations.updateTexture2D(bgfxHandle, mipLevel, x, y, width, height, memory);
+    }
+
+    /**
+     * Update texture data from a region of a NativeImage, read from its native pixels without a heap copy.
+     */
+    public boolean updateData(int mipLevel, int x, int y, int width, int height, NativeImage image, int srcX, int srcY) {
+        int bytesPerPixel = image.format().components();
+        int srcPitch = image.getWidth() * bytesPerPixel;
+        if (srcX >= 0 && srcY >= 0 && srcX + width <= image.getWidth() && srcY + height <= image.getHeight()) {
+            trackMipWrite(mipLevel, x, y, width, height,
+                image.getPointer() + (long) srcY * srcPitch + (long) srcX * bytesPerPixel, srcPitch, bytesPerPixel);
+        }
+        return BgfxOperations.updateTexture2D(bgfxHandle, mipLevel, x, y, width, height, image, srcX, srcY);
+    }
+
+    /**
+     * Keep the mip chain in step with a write. Level 0 writes are staged in it (only the written region
+     * is copied) and the levels below are rebuilt at the end of the frame; a write to any other level
+     * means the uploader builds its own mips, so the chain and its staged writes are dropped for good.
+     */
+    private void trackMipWrite(int mipLevel, int x, int y, int width, int height, long srcAddress, long size) {
+        // Tightly packed rows; anything else does not match the chain's texel size
+        long texels = (long) width * height;
+        int bytesPerPixel = texels > 0 && size % texels == 0 ? (int) (size / texels) : 0;
+        trackMipWrite(mipLevel, x, y, width, height, srcAddress, width * bytesPerPixel, bytesPerPixel);
+    }
+
+    private synchronized void trackMipWrite(int mipLevel, int x, int y, int width, int height,
+                                            long srcAddress, int srcPitch, int bytesPerPixel) {
+        if (mipChainDisabled) {
+            return;
+        }
+        if (mipLevel > 0) {
+            releaseMipChain();
+            mipChainDisabled = true;
+            return;
+        }
+        if (mipChain == null) {
+            mipChain = BgfxMipmaps.createChain(textureName, bgfxHandle, textureWidth, textureHeight, getMipLevels(), bgfxFormat);
+            if (mipChain == null) {
+                mipChainDisabled = true;
+                return;
+            }
+        }
+        if (bytesPerPixel != mipChain.getBytesPerPixel()) {
+            LOGGER.warn("Write of {} bytes per pixel to {} does not match its format, not updating its mips",
+                bytesPerPixel, textureName);
+            return;
+        }
+        BgfxMipmaps.write(mipChain, x, y, width, height, srcAddress, srcPitch);
+    }
+
+    private synchronized void releaseMipChain() {
+        if (mipChain != null) {
+            BgfxMipmaps.release(mipChain);
+            mipChain = null;
+        }
+    }
+
     /**
      * Read texture data using BGFX native functionality.
      * BGFX handles all validation internally.
@@ -122,6 +208,8 @@ public class BgfxTexture extends GpuTexture {
     public void close() {
         if (!closed && bgfxHandle != 0) {
             LOGGER.debug("Destroying texture: {} (handle: {})", textureName, bgfxHandle);
+            BgfxViews.releaseTexture(bgfxHandle);
+            releaseMipChain();
             BgfxOperations.destroyResource(bgfxHandle, "texture");
             closed = true;
         }
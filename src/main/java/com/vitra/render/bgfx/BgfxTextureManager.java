@@ -21,8 +21,8 @@ import java.util.concurrent.ConcurrentHashMap;
  * - bgfx_create_texture_2d() - Create texture from image data
  * - bgfx_set_texture() - Bind texture to shader sampler
  * - bgfx_destroy_texture() - Release texture resource
- * - bgfx_create_uniform() - Create uniform handle for sampler
- * - bgfx_destroy_uniform() - Release uniform handle
+ *
+ * Sampler uniform handles come from BgfxUniformRegistry.
  *
  * NO custom texture format conversions or custom implementations.
  * All texture operations are delegated to BGFX's native API.
@@ -36,26 +36,26 @@ public class BgfxTextureManager {
     // Cache: GpuTexture -> BGFX texture handle (for dynamic textures like fonts)
     private static final Map<GpuTexture, Short> gpuTextureHandles = new ConcurrentHashMap<>();
 
-    // Cache: Texture unit -> BGFX uniform handle for samplers
-    private final Map<Integer, Short> samplerUniforms = new ConcurrentHashMap<>();
+    // Texture unit -> BgfxUniformRegistry ID of its sampler ("s_texColor", "s_texColor1", ...)
+    private static final int[] samplerIds = new int[16];
+
+    static {
+        for (int unit = 0; unit < samplerIds.length; unit++) {
+            samplerIds[unit] = BgfxUniformRegistry.internSampler("s_texColor" + (unit == 0 ? "" : unit));
+        }
+    }
 
     // Track active textures per unit (for bgfx_set_texture)
     private final short[] activeTextures = new short[16]; // Units 0-15
 
     /**
-     * Get or create BGFX uniform handle for a texture sampler.
-     * Uses: bgfx_create_uniform()
+     * Get the BGFX uniform handle for a texture unit's sampler.
      *
      * @param unit Texture unit (0-15)
      * @return BGFX uniform handle
      */
     public short getSamplerUniform(int unit) {
-        return samplerUniforms.computeIfAbsent(unit, u -> {
-            String samplerName = "s_texColor" + (u == 0 ? "" : u);
-            short uniform = BGFX.bgfx_create_uniform(samplerName, BGFX.BGFX_UNIFORM_TYPE_SAMPLER, 1);
-            LOGGER.debug("Created BGFX sampler uniform '{}' for unit {}: handle={}", samplerName, u, uniform);
-            return uniform;
-        });
+        return BgfxUniformRegistry.getHandle(samplerIds[unit]);
     }
 
     /**
@@ -107,7 +107,8 @@ public class BgfxTextureManager {
      */
     public void destroyTexture(short textureHandle) {
         if (Util.isValidHandle(textureHandle)) {
-            BGFX.bgfx_destroy_texture(textureHandle);
+            BgfxUploadCoalescer.release(textureHandle);
+            BgfxRenderQueue.execute(() -> BGFX.bgfx_destroy_texture(textureHandle));
             LOGGER.debug("Destroyed BGFX texture: handle={}", textureHandle);
         }
     }
@@ -153,6 +154,9 @@ public class BgfxTextureManager {
      * Upload texture data from NativeImage to BGFX texture.
      * Uses: bgfx_update_texture_2d()
      *
+     * Pixels are read straight from the image's native memory (NativeImage's byte order already
+     * matches BGFX's RGBA8), copied once into an upload block with the image's row pitch.
+     *
      * @param textureHandle BGFX texture handle
      * @param image NativeImage containing pixel data
      * @param mipLevel Mipmap level (0 for base)
@@ -160,65 +164,21 @@ public class BgfxTextureManager {
      * @param offsetY Y offset in texture
      * @param width Width of region to update
      * @param height Height of region to update
+     * @param skipPixels First column of the region in the image
+     * @param skipRows First row of the region in the image
      */
     public static void uploadTextureData(short textureHandle, NativeImage image,
                                         int mipLevel, int offsetX, int offsetY,
-                                        int width, int height) {
+                                        int width, int height, int skipPixels, int skipRows) {
         if (!Util.isValidHandle(textureHandle)) {
             LOGGER.error("Invalid texture handle in uploadTextureData");
             return;
         }
 
-        try {
-            // NativeImage stores pixels in a ByteBuffer internally
-            // We need to access it via makePixelArray() or convert to ByteBuffer
-
-            // Allocate ByteBuffer for pixel data
-            int imageSize = width * height * 4; // RGBA = 4 bytes per pixel
-            ByteBuffer pixelBuffer = ByteBuffer.allocateDirect(imageSize);
-
-            // Copy pixel data from NativeImage to ByteBuffer
-            // NativeImage stores pixels as ABGR (int), we need RGBA
-            for (int y = 0; y < height; y++) {
-                for (int x = 0; x < width; x++) {
-                    int pixel = image.getPixel(x, y);
-
-                    // NativeImage pixel format is ABGR (0xAABBGGRR)
-                    int a = (pixel >> 24) & 0xFF;
-                    int b = (pixel >> 16) & 0xFF;
-                    int g = (pixel >> 8) & 0xFF;
-                    int r = pixel & 0xFF;
-
-                    // Write as RGBA
-                    pixelBuffer.put((byte) r);
-                    pixelBuffer.put((byte) g);
-                    pixelBuffer.put((byte) b);
-                    pixelBuffer.put((byte) a);
-                }
-            }
-            pixelBuffer.flip();
-
-            // Create BGFX memory from ByteBuffer
-            BGFXMemory memory = BGFX.bgfx_copy(pixelBuffer);
-
-            // Upload to BGFX texture
-            BGFX.bgfx_update_texture_2d(
-                textureHandle,
-                0,           // layer
-                (byte) mipLevel,
-                (short) offsetX,
-                (short) offsetY,
-                (short) width,
-                (short) height,
-                memory,
-                (short) (width * 4) // pitch (bytes per row)
-            );
-
-            LOGGER.trace("Uploaded texture data: handle={}, offset=({},{}), size={}x{}",
-                textureHandle, offsetX, offsetY, width, height);
-
-        } catch (Exception e) {
-            LOGGER.error("Failed to upload texture data", e);
+        if (BgfxOperations.updateTexture2D(textureHandle, mipLevel, offsetX, offsetY, width, height,
+                image, skipPixels, skipRows)) {
+            LOGGER.trace("Uploaded texture data: handle={}, offset=({},{}), size={}x{}, skip=({},{})",
+                textureHandle, offsetX, offsetY, width, height, skipPixels, skipRows);
         }
     }
 
@@ -246,12 +206,11 @@ public class BgfxTextureManager {
 
         try {
             // Convert IntBuffer to ByteBuffer
-            ByteBuffer byteBuffer = ByteBuffer.allocateDirect(buffer.remaining() * 4);
+            ByteBuffer byteBuffer = BgfxUploadPool.acquire(buffer.remaining() * 4);
             byteBuffer.asIntBuffer().put(buffer);
-            byteBuffer.position(0);
 
-            // Create BGFX memory from buffer
-            BGFXMemory memory = BGFX.bgfx_copy(byteBuffer);
+            // Hand the pooled block to BGFX without copying
+            BGFXMemory memory = BgfxUploadPool.submit(byteBuffer);
 
             // Upload to BGFX texture
             BGFX.bgfx_update_texture_2d(
@@ -290,7 +249,7 @@ public class BgfxTextureManager {
 
     /**
      * Cleanup all resources using BGFX native methods.
-     * Uses: bgfx_destroy_texture(), bgfx_destroy_uniform()
+     * Uses: bgfx_destroy_texture()
      */
     public void shutdown() {
         // Destroy all texture handles
@@ -309,14 +268,6 @@ public class BgfxTextureManager {
         });
         gpuTextureHandles.clear();
 
-        // Destroy all sampler uniforms
-        samplerUniforms.values().forEach(uniform -> {
-            if (Util.isValidHandle(uniform)) {
-                BGFX.bgfx_destroy_uniform(uniform);
-            }
-        });
-        samplerUniforms.clear();
-
         LOGGER.info("BgfxTextureManager shutdown complete");
     }
 }
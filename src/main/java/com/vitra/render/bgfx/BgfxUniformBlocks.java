@@ -0,0 +1,225 @@
+package com.vitra.render.bgfx;
+
+import org.lwjgl.bgfx.BGFX;
+import org.lwjgl.system.MemoryStack;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.Arrays;
+import java.util.Map;
+import java.util.concurrent.ConcurrentHashMap;
+
+/**
+ * Decoder from Minecraft's std140 uniform blocks to named BGFX uniforms.
+ *
+ * Minecraft 1.21.8 binds whole uniform blocks (RenderPass.setUniform), while BGFX only has vec4 and
+ * mat4 uniforms. Each known block is described by its std140 layout: mat4 members map to mat4
+ * uniforms, and every other 16-byte row maps to one vec4 uniform. Scalars that share a row travel
+ * together, and int members are converted to float. Blocks not listed here are uploaded as a
+ * vec4 array named after the block.
+ *
+ * bgfx_encoder_set_uniform() is called only for blocks whose bytes differ from the last upload in
+ * the same view. The last bytes of each block are kept per view and compared exactly, so an unchanged
+ * block costs a memory compare and no BGFX call. Uniform values persist between draws in BGFX, which
+ * renders views in view ID order, not in submission order: the draw rendered before a draw of a
+ * sequential view is the view's previous draw, or a draw of another view if it is the view's first
+ * (which is never skipped). The comparison cache is dropped every frame in {@link #endFrame()}.
+ * Change detection is for the render thread only; other threads must force uploads.
+ *
+ * Uniform handles come from BgfxUniformRegistry.
+ *
+ * Uses: bgfx_encoder_set_uniform()
+ */
+public final class BgfxUniformBlocks {
+    private static final Logger LOGGER = LoggerFactory.getLogger("BgfxUniformBlocks");
+
+    private static final int ROW_SIZE = 16;
+
+    // BGFX_CONFIG_MAX_VIEWS
+    private static final int MAX_VIEWS = 256;
+
+    /**
+     * One BGFX uniform fed from a std140 row (vec4) or four rows (mat4) of a block.
+     * intMask marks row components that hold ints (bit 0 = x .. bit 3 = w).
+     * id is the uniform's BgfxUniformRegistry ID.
+     */
+    private record Field(String uniform, int type, int offset, int num, int intMask, int id) {
+        Field(String uniform, int type, int offset, int num, int intMask) {
+            this(uniform, type, offset, num, intMask, BgfxUniformRegistry.intern(uniform, type, num));
+        }
+
+        int size() {
+            return (type == BGFX.BGFX_UNIFORM_TYPE_MAT4 ? 4 * ROW_SIZE : ROW_SIZE) * num;
+        }
+    }
+
+    private static final class Block {
+        final String name;
+        final Field[] fields;
+        // Bytes last passed to BGFX per view; only meaningful while `current` is set for the view
+        final ByteBuffer[] lastData = new ByteBuffer[MAX_VIEWS];
+        final boolean[] current = new boolean[MAX_VIEWS];
+
+        Block(String name, Field... fields) {
+            this.name = name;
+            this.fields = fields;
+        }
+    }
+
+    private static final Map<String, Block> blocks = new ConcurrentHashMap<>();
+
+    static {
+        // mat4 ModelViewMat; vec4 ColorModulator; vec3 ModelOffset; mat4 TextureMat; float LineWidth
+        register(new Block("DynamicTransforms",
+            mat4("u_modelViewMat", 0),
+            vec4("u_colorModulator", 64),
+            vec4("u_modelOffset", 80),
+            mat4("u_textureMat", 96),
+            vec4("u_lineWidth", 160)));
+
+        // mat4 ProjMat
+        register(new Block("Projection",
+            mat4("u_projMat", 0)));
+
+        // vec4 FogColor; float FogEnvironmentalStart, FogEnvironmentalEnd, FogRenderDistanceStart,
+        // FogRenderDistanceEnd, FogSkyEnd, FogCloudsEnd
+        register(new Block("Fog",
+            vec4("u_fogColor", 0),
+            vec4("u_fogEnvironmental_RenderDistance", 16),
+            vec4("u_fogSkyEnd_CloudsEnd", 32)));
+
+        // vec2 ScreenSize; float GlintAlpha; float GameTime; int MenuBlurRadius
+        register(new Block("Globals",
+            vec4("u_ScreenSize_GlintAlpha_GameTime", 0),
+            new Field("u_MenuBlurRadius", BGFX.BGFX_UNIFORM_TYPE_VEC4, 16, 1, 0b0001)));
+
+        // vec3 Light0_Direction; vec3 Light1_Direction
+        register(new Block("Lighting",
+            vec4("u_light0Direction", 0),
+            vec4("u_light1Direction", 16)));
+    }
+
+    private static Field vec4(String uniform, int offset) {
+        return new Field(uniform, BGFX.BGFX_UNIFORM_TYPE_VEC4, offset, 1, 0);
+    }
+
+    private static Field mat4(String uniform, int offset) {
+        return new Field(uniform, BGFX.BGFX_UNIFORM_TYPE_MAT4, offset, 1, 0);
+    }
+
+    private static void register(Block block) {
+        blocks.put(block.name, block);
+    }
+
+    /**
+     * Upload a uniform block for the next submit on an encoder, if its bytes changed since the last upload.
+     *
+     * Draws in sorted views (see BgfxSortKeys) reach the GPU in a different order than they were
+     * submitted, so a value skipped for one of them could come from whichever draw BGFX renders
+     * before it. Such draws pass force = true to always upload. The comparison cache only follows the
+     * render thread's main encoder; draws recorded on worker encoders must force as well.
+     *
+     * @param encoder Encoder the next draw is recorded on
+     * @param viewId View the next draw is submitted to
+     * @param blockName Uniform block name as bound by Minecraft (e.g. "DynamicTransforms")
+     * @param data Block contents in std140 layout (position..limit); not modified
+     * @param force Upload even if the bytes match the last upload
+     * @return true if bgfx_encoder_set_uniform() was called
+     */
+    public static boolean apply(long encoder, int viewId, String blockName, ByteBuffer data, boolean force) {
+        Block block = blocks.computeIfAbsent(blockName, name -> genericBlock(name, data.remaining()));
+
+        ByteBuffer bytes = data.slice().order(ByteOrder.nativeOrder());
+        ByteBuffer last = block.lastData[viewId];
+        if (!force && block.current[viewId] && last.capacity() == bytes.remaining() && last.mismatch(bytes) == -1) {
+            return false;
+        }
+
+        for (Field field : block.fields) {
+            if (field.offset() + field.size() > bytes.remaining()) {
+                continue;
+            }
+
+            short handle = BgfxUniformRegistry.getHandle(field.id());
+            if (!Util.isValidHandle(handle)) {
+                continue;
+            }
+
+            ByteBuffer value = bytes.slice(field.offset(), field.size()).order(ByteOrder.nativeOrder());
+            if (field.intMask() == 0) {
+                BGFX.bgfx_encoder_set_uniform(encoder, handle, value, field.num());
+            } else {
+                try (MemoryStack stack = MemoryStack.stackPush()) {
+                    ByteBuffer converted = stack.malloc(ROW_SIZE);
+                    for (int c = 0; c < 4; c++) {
+                        int at = c * 4;
+                        converted.putFloat(at, (field.intMask() & (1 << c)) != 0 ? value.getInt(at) : value.getFloat(at));
+                    }
+                    BGFX.bgfx_encoder_set_uniform(encoder, handle, converted, 1);
+                }
+            }
+        }
+
+        // Remember what BGFX now holds; forced uploads may come from other encoders, so only drop the cache
+        if (force) {
+            block.current[viewId] = false;
+            return true;
+        }
+        if (last == null || last.capacity() != bytes.remaining()) {
+            last = ByteBuffer.allocateDirect(bytes.remaining()).order(ByteOrder.nativeOrder());
+            block.lastData[viewId] = last;
+        }
+        last.put(0, bytes, 0, bytes.remaining());
+        block.current[viewId] = true;
+        return true;
+    }
+
+    /**
+     * Squared length of ModelOffset (camera-relative origin of the draw) in a DynamicTransforms block,
+     * or -1 if the block is too short.
+     */
+    public static float modelOffsetDistanceSq(ByteBuffer dynamicTransforms) {
+        ByteBuffer bytes = dynamicTransforms.slice().order(ByteOrder.nativeOrder());
+        if (bytes.remaining() < 80 + 12) {
+            return -1.0f;
+        }
+        float x = bytes.getFloat(80);
+        float y = bytes.getFloat(84);
+        float z = bytes.getFloat(88);
+        return x * x + y * y + z * z;
+    }
+
+    /**
+     * Layout for a block without an explicit description: the whole block as a vec4 array.
+     */
+    private static Block genericBlock(String name, int size) {
+        LOGGER.debug("No std140 layout for uniform block {} ({} bytes), uploading as vec4 array", name, size);
+        return new Block(name, new Field(name, BGFX.BGFX_UNIFORM_TYPE_VEC4, 0, Math.max(size / ROW_SIZE, 1), 0));
+    }
+
+    /**
+     * Forget the last uploaded bytes so every block is uploaded again in the next frame.
+     * Called after bgfx_frame().
+     */
+    public static void endFrame() {
+        for (Block block : blocks.values()) {
+            Arrays.fill(block.current, false);
+        }
+    }
+
+    /**
+     * Drop cached block contents. Called on renderer shutdown, before BgfxUniformRegistry.shutdown().
+     */
+    public static void shutdown() {
+        for (Block block : blocks.values()) {
+            Arrays.fill(block.lastData, null);
+            Arrays.fill(block.current, false);
+        }
+        LOGGER.info("Uniform block decoder shutdown complete");
+    }
+
+    private BgfxUniformBlocks() {
+    }
+}
@@ -0,0 +1,139 @@
+package com.vitra.render.bgfx;
+
+import org.lwjgl.bgfx.BGFX;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+import java.util.Arrays;
+import java.util.Map;
+import java.util.concurrent.ConcurrentHashMap;
+
+/**
+ * Device-wide table of BGFX uniform and sampler handles, interned by name.
+ *
+ * Names ("Sampler0", "u_modelViewMat", ...) are interned once into small integer IDs, normally when
+ * a pipeline is precompiled, and each ID owns one BGFX handle for the lifetime of the renderer.
+ * Render passes and the uniform decoder keep the IDs and look handles up by array index, so the
+ * draw path neither hashes strings nor creates or destroys uniforms.
+ *
+ * Interning is thread-safe. Handles are created when BGFX is up: immediately if it already is,
+ * otherwise on first lookup.
+ *
+ * Uses: bgfx_create_uniform(), bgfx_destroy_uniform()
+ */
+public final class BgfxUniformRegistry {
+    private static final Logger LOGGER = LoggerFactory.getLogger("BgfxUniformRegistry");
+
+    private static final class Entry {
+        final String name;
+        final int type;
+        final int num;
+        volatile short handle = BGFX.BGFX_INVALID_HANDLE;
+
+        Entry(String name, int type, int num) {
+            this.name = name;
+            this.type = type;
+            this.num = num;
+        }
+    }
+
+    private static final Map<String, Integer> ids = new ConcurrentHashMap<>();
+    private static volatile Entry[] entries = new Entry[64];
+    private static int count = 0;
+
+    /**
+     * Get the ID for a uniform name, registering it on first use.
+     *
+     * @param name BGFX uniform name
+     * @param type BGFX_UNIFORM_TYPE_* (the type of the first registration wins)
+     * @param num Array size
+     */
+    public static int intern(String name, int type, int num) {
+        Integer id = ids.get(name);
+        if (id != null) {
+            Entry entry = entries[id];
+            if (entry.type != type || entry.num != num) {
+                LOGGER.warn("Uniform '{}' already registered as type {} x{}, ignoring type {} x{}",
+                    name, entry.type, entry.num, type, num);
+            }
+            return id;
+        }
+
+        synchronized (BgfxUniformRegistry.class) {
+            id = ids.get(name);
+            if (id != null) {
+                return id;
+            }
+
+            if (count == entries.length) {
+                entries = Arrays.copyOf(entries, count * 2);
+            }
+            Entry entry = new Entry(name, type, num);
+            if (Util.isInitialized()) {
+                entry.handle = create(entry);
+            }
+            entries[count] = entry;
+            ids.put(name, count);
+
+            LOGGER.debug("Registered uniform '{}' as ID {} (handle: {})", name, count, entry.handle);
+            return count++;
+        }
+    }
+
+    /**
+     * Get the ID for a sampler name, registering it on first use.
+     */
+    public static int internSampler(String name) {
+        return intern(name, BGFX.BGFX_UNIFORM_TYPE_SAMPLER, 1);
+    }
+
+    /**
+     * BGFX handle for an interned ID.
+     */
+    public static short getHandle(int id) {
+        Entry entry = entries[id];
+        short handle = entry.handle;
+        if (!Util.isValidHandle(handle)) {
+            synchronized (entry) {
+                handle = entry.handle;
+                if (!Util.isValidHandle(handle)) {
+                    handle = create(entry);
+                    entry.handle = handle;
+                }
+            }
+        }
+        return handle;
+    }
+
+    public static String getName(int id) {
+        return entries[id].name;
+    }
+
+    private static short create(Entry entry) {
+        short handle = BGFX.bgfx_create_uniform(entry.name, entry.type, entry.num);
+        if (!Util.isValidHandle(handle)) {
+            LOGGER.error("Failed to create uniform '{}'", entry.name);
+        }
+        return handle;
+    }
+
+    /**
+     * Destroy all handles. IDs stay valid; their handles are recreated if BGFX is initialized again.
+     * Called on renderer shutdown.
+     */
+    public static synchronized void shutdown() {
+        int destroyed = 0;
+        for (int i = 0; i < count; i++) {
+            Entry entry = entries[i];
+            if (Util.isValidHandle(entry.handle)) {
+                BGFX.bgfx_destroy_uniform(entry.handle);
+                entry.handle = BGFX.BGFX_INVALID_HANDLE;
+                destroyed++;
+            }
+        }
+        LOGGER.info("Uniform registry shutdown complete ({} of {} handles destroyed)", destroyed, count);
+    }
+
+    private BgfxUniformRegistry() {
+    }
+}
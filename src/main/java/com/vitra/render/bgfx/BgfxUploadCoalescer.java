@@ -0,0 +1,303 @@
+package com.vitra.render.bgfx;
+
+import org.lwjgl.bgfx.BGFX;
+import org.lwjgl.bgfx.BGFXMemory;
+import org.lwjgl.system.MemoryUtil;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+import java.nio.ByteBuffer;
+import java.util.ArrayList;
+import java.util.Iterator;
+import java.util.LinkedHashMap;
+import java.util.List;
+import java.util.Map;
+
+/**
+ * Per-frame collector of texture sub-uploads, merged into as few bgfx_update_texture_2d() calls as possible.
+ *
+ * Animated sprites (water, lava, fire, portals) each upload their frame into the atlas separately, every
+ * tick, per mip level. Writes are staged here during the frame, per texture and mip, each as a tightly
+ * packed copy of its rectangle. At {@link #flush()} (right before bgfx_frame()) the writes of a target are
+ * merged and uploaded:
+ * - a write covered by a later one is dropped
+ * - a write is merged into one it covers
+ * - writes in the same row band (same y and height) or column band (same x and width) that touch or
+ *   overlap become one rectangle
+ * A merged rectangle is always exactly covered by its writes, so no texels are uploaded that were not
+ * written this frame. Merging a full-mip update from scattered rects would need the untouched texels,
+ * which no longer exist on the CPU once an atlas is stitched; a mip that is fully rewritten still ends
+ * up as a single update.
+ *
+ * BGFX applies all texture updates of a frame before its draws, so deferring writes to the end of the
+ * frame changes nothing on screen. Thread-safe; uploads run through BgfxRenderQueue.
+ *
+ * Uses: bgfx_update_texture_2d()
+ */
+public final class BgfxUploadCoalescer {
+    private static final Logger LOGGER = LoggerFactory.getLogger("BgfxUploadCoalescer");
+
+    /**
+     * Source of a target's texture handle, read when the upload runs (GL-emulated textures are created
+     * through BgfxRenderQueue and may not have a handle when they are written).
+     */
+    @FunctionalInterface
+    public interface HandleSource {
+        short getBgfxHandle();
+    }
+
+    private record Target(Object texture, int mipLevel) {
+    }
+
+    /**
+     * One staged rectangle; block holds its texels tightly packed (width * bytesPerPixel per row).
+     */
+    private record Write(int x, int y, int width, int height, ByteBuffer block) {
+        boolean contains(Write other) {
+            return other.x >= x && other.y >= y && other.x + other.width <= x + width && other.y + other.height <= y + height;
+        }
+
+        boolean intersects(int ox, int oy, int owidth, int oheight) {
+            return ox < x + width && x < ox + owidth && oy < y + height && y < oy + oheight;
+        }
+    }
+
+    private static final class Pending {
+        final HandleSource source;
+        final int bytesPerPixel;
+        final List<Write> writes = new ArrayList<>();
+
+        Pending(HandleSource source, int bytesPerPixel) {
+            this.source = source;
+            this.bytesPerPixel = bytesPerPixel;
+        }
+    }
+
+    private static final Map<Target, Pending> pending = new LinkedHashMap<>();
+
+    private static int writesThisFrame;
+    private static int uploadsThisFrame;
+    private static long bytesThisFrame;
+    private static String lastFrameStats = "";
+
+    /**
+     * Stage a rectangle copied from native texels whose rows are srcPitch bytes apart.
+     *
+     * @param texture Identity of the texture (a handle or the texture object); writes are merged per texture and mip
+     */
+    public static void write(Object texture, HandleSource source, int mipLevel, int bytesPerPixel,
+                             int x, int y, int width, int height, long srcAddress, int srcPitch) {
+        if (width <= 0 || height <= 0) {
+            return;
+        }
+        int rowBytes = width * bytesPerPixel;
+        ByteBuffer block = BgfxUploadPool.acquire(rowBytes * height);
+        long dst = MemoryUtil.memAddress(block);
+        if (srcPitch == rowBytes) {
+            MemoryUtil.memCopy(srcAddress, dst, (long) rowBytes * height);
+        } else {
+            for (int row = 0; row < height; row++) {
+                MemoryUtil.memCopy(srcAddress + (long) row * srcPitch, dst + (long) row * rowBytes, rowBytes);
+            }
+        }
+        writeBlock(texture, source, mipLevel, bytesPerPixel, x, y, width, height, block);
+    }
+
+    /**
+     * Stage a rectangle already packed in a BgfxUploadPool block, which the coalescer takes over.
+     */
+    public static synchronized void writeBlock(Object texture, HandleSource source, int mipLevel, int bytesPerPixel,
+                                               int x, int y, int width, int height, ByteBuffer block) {
+        Pending target = pending.computeIfAbsent(new Target(texture, mipLevel), t -> new Pending(source, bytesPerPixel));
+        if (target.bytesPerPixel != bytesPerPixel) {
+            // Texel size changed (texture recreated with another format): what is staged is stale
+            releaseWrites(target.writes);
+            target = new Pending(source, bytesPerPixel);
+            pending.put(new Target(texture, mipLevel), target);
+        }
+        target.writes.add(new Write(x, y, width, height, block));
+        writesThisFrame++;
+    }
+
+    /**
+     * Merge and upload everything staged this frame. Called right before bgfx_frame().
+     */
+    public static synchronized void flush() {
+        for (Map.Entry<Target, Pending> entry : pending.entrySet()) {
+            Pending target = entry.getValue();
+            coalesce(target.writes, target.bytesPerPixel);
+            for (Write write : target.writes) {
+                upload(target.source, entry.getKey().mipLevel(), write);
+            }
+        }
+        pending.clear();
+
+        lastFrameStats = String.format("writes=%d uploads=%d bytes=%d", writesThisFrame, uploadsThisFrame, bytesThisFrame);
+        writesThisFrame = 0;
+        uploadsThisFrame = 0;
+        bytesThisFrame = 0;
+    }
+
+    private static void upload(HandleSource source, int mipLevel, Write write) {
+        BGFXMemory memory = BgfxUploadPool.submit(write.block());
+        uploadsThisFrame++;
+        bytesThisFrame += memory.size();
+        BgfxRenderQueue.execute(() -> {
+            short handle = source.getBgfxHandle();
+            if (!Util.isValidHandle(handle)) {
+                LOGGER.warn("Dropping {}x{} texture upload: texture has no BGFX handle", write.width(), write.height());
+                return;
+            }
+            BGFX.bgfx_update_texture_2d(handle, 0, (byte) mipLevel, (short) write.x(), (short) write.y(),
+                (short) write.width(), (short) write.height(), memory, (short) 0xFFFF);
+        });
+    }
+
+    /**
+     * Merge writes in place until no pair can be merged. Writes keep their order: a pair is only merged
+     * if no write between them touches the merged area, so later writes still win where they overlap.
+     */
+    private static void coalesce(List<Write> writes, int bytesPerPixel) {
+        boolean merged = true;
+        while (merged) {
+            merged = false;
+            search:
+            for (int i = 0; i < writes.size(); i++) {
+                for (int j = i + 1; j < writes.size(); j++) {
+                    Write earlier = writes.get(i);
+                    Write later = writes.get(j);
+                    int[] area = unionArea(earlier, later);
+                    if (area == null || !isClear(writes, i, j, area)) {
+                        continue;
+                    }
+                    writes.set(i, merge(earlier, later, area, bytesPerPixel));
+                    writes.remove(j);
+                    merged = true;
+                    break search;
+                }
+            }
+        }
+    }
+
+    /**
+     * Whether no write strictly between i and j intersects an area.
+     */
+    private static boolean isClear(List<Write> writes, int i, int j, int[] area) {
+        for (int k = i + 1; k < j; k++) {
+            if (writes.get(k).intersects(area[0], area[1], area[2], area[3])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * The union of two writes as {x, y, width, height} if it is exactly a rectangle, or null.
+     */
+    private static int[] unionArea(Write earlier, Write later) {
+        if (later.contains(earlier)) {
+            return new int[] {later.x(), later.y(), later.width(), later.height()};
+        }
+        if (earlier.contains(later)) {
+            return new int[] {earlier.x(), earlier.y(), earlier.width(), earlier.height()};
+        }
+
+        boolean rowBand = earlier.y() == later.y() && earlier.height() == later.height()
+            && earlier.x() <= later.x() + later.width() && later.x() <= earlier.x() + earlier.width();
+        boolean columnBand = earlier.x() == later.x() && earlier.width() == later.width()
+            && earlier.y() <= later.y() + later.height() && later.y() <= earlier.y() + earlier.height();
+        if (!rowBand && !columnBand) {
+            return null;
+        }
+
+        int x = Math.min(earlier.x(), later.x());
+        int y = Math.min(earlier.y(), later.y());
+        int width = Math.max(earlier.x() + earlier.width(), later.x() + later.width()) - x;
+        int height = Math.max(earlier.y() + earlier.height(), later.y() + later.height()) - y;
+        return new int[] {x, y, width, height};
+    }
+
+    /**
+     * Merge an earlier and a later write into their union area (from {@link #unionArea}).
+     * The blocks of the inputs are consumed.
+     */
+    private static Write merge(Write earlier, Write later, int[] area, int bytesPerPixel) {
+        if (later.contains(earlier)) {
+            BgfxUploadPool.release(earlier.block());
+            return later;
+        }
+        if (earlier.contains(later)) {
+            copyInto(earlier, later, bytesPerPixel);
+            BgfxUploadPool.release(later.block());
+            return earlier;
+        }
+
+        Write union = new Write(area[0], area[1], area[2], area[3],
+            BgfxUploadPool.acquire(area[2] * area[3] * bytesPerPixel));
+        copyInto(union, earlier, bytesPerPixel);
+        copyInto(union, later, bytesPerPixel);
+        BgfxUploadPool.release(earlier.block());
+        BgfxUploadPool.release(later.block());
+        return union;
+    }
+
+    /**
+     * Copy a write's texels into the part of a containing write it covers.
+     */
+    private static void copyInto(Write dst, Write src, int bytesPerPixel) {
+        long srcAddress = MemoryUtil.memAddress(src.block());
+        long dstAddress = MemoryUtil.memAddress(dst.block());
+        int srcRowBytes = src.width() * bytesPerPixel;
+        int dstRowBytes = dst.width() * bytesPerPixel;
+        long dstStart = dstAddress + (long) (src.y() - dst.y()) * dstRowBytes + (long) (src.x() - dst.x()) * bytesPerPixel;
+        if (srcRowBytes == dstRowBytes) {
+            MemoryUtil.memCopy(srcAddress, dstStart, (long) srcRowBytes * src.height());
+            return;
+        }
+        for (int row = 0; row < src.height(); row++) {
+            MemoryUtil.memCopy(srcAddress + (long) row * srcRowBytes, dstStart + (long) row * dstRowBytes, srcRowBytes);
+        }
+    }
+
+    /**
+     * Drop staged writes of a texture that is being destroyed.
+     */
+    public static synchronized void release(Object texture) {
+        Iterator<Map.Entry<Target, Pending>> it = pending.entrySet().iterator();
+        while (it.hasNext()) {
+            Map.Entry<Target, Pending> entry = it.next();
+            if (entry.getKey().texture().equals(texture)) {
+                releaseWrites(entry.getValue().writes);
+                it.remove();
+            }
+        }
+    }
+
+    private static void releaseWrites(List<Write> writes) {
+        for (Write write : writes) {
+            BgfxUploadPool.release(write.block());
+        }
+        writes.clear();
+    }
+
+    /**
+     * Staged writes, issued uploads and uploaded bytes of the last frame.
+     */
+    public static synchronized String getStats() {
+        return lastFrameStats;
+    }
+
+    /**
+     * Drop everything staged. Called on renderer shutdown.
+     */
+    public static synchronized void shutdown() {
+        for (Pending target : pending.values()) {
+            releaseWrites(target.writes);
+        }
+        pending.clear();
+        LOGGER.info("Upload coalescer shutdown complete");
+    }
+
+    private BgfxUploadCoalescer() {
+    }
+}
@@ -0,0 +1,155 @@
+package com.vitra.render.bgfx;
+
+import org.lwjgl.bgfx.BGFX;
+import org.lwjgl.bgfx.BGFXMemory;
+import org.lwjgl.bgfx.BGFXReleaseFunctionCallback;
+import org.lwjgl.system.MemoryUtil;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+import java.nio.ByteBuffer;
+import java.util.Map;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.concurrent.atomic.AtomicLong;
+
+/**
+ * Pool of native upload blocks handed to BGFX without copying.
+ *
+ * Producers (texture uploads, shader loading, mapped buffers) write straight into a block from
+ * {@link #acquire(int)} and pass it to BGFX with {@link #submit(ByteBuffer)}. BGFX references the
+ * block in place and fires the release callback once it has consumed the data, at which point the
+ * block returns to its size class for reuse. Compared to bgfx_copy() this saves one full memcpy
+ * and one BGFX allocation per upload.
+ *
+ * Blocks are bucketed into power-of-two size classes. Memory BGFX is still reading is tracked as
+ * in flight and never reused. Thread-safe: the release callback runs on BGFX's render thread.
+ *
+ * Uses: bgfx_make_ref_release()
+ */
+public final class BgfxUploadPool {
+    private static final Logger LOGGER = LoggerFactory.getLogger("BgfxUploadPool");
+
+    // Size classes: 256 B .. 64 MB; larger requests are allocated unpooled
+    private static final int MIN_CLASS_SHIFT = 8;
+    private static final int MAX_CLASS_SHIFT = 26;
+    private static final int CLASS_COUNT = MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1;
+
+    // Free blocks retained beyond this are returned to the system allocator
+    private static final long MAX_POOLED_BYTES = 128L * 1024 * 1024;
+
+    @SuppressWarnings("unchecked")
+    private static final ConcurrentLinkedQueue<ByteBuffer>[] freeBlocks = new ConcurrentLinkedQueue[CLASS_COUNT];
+
+    // Data address -> block, for blocks BGFX has not released yet
+    private static final Map<Long, ByteBuffer> inFlight = new ConcurrentHashMap<>();
+
+    private static final AtomicLong pooledBytes = new AtomicLong();
+    private static final AtomicLong inFlightBytes = new AtomicLong();
+
+    // Single native upcall shared by every submission; lives for the lifetime of the process
+    private static final BGFXReleaseFunctionCallback RELEASE_CALLBACK =
+        BGFXReleaseFunctionCallback.create((ptr, userData) -> onRelease(ptr));
+
+    static {
+        for (int i = 0; i < CLASS_COUNT; i++) {
+            freeBlocks[i] = new ConcurrentLinkedQueue<>();
+        }
+    }
+
+    /**
+     * Get a native block with at least {@code size} bytes, positioned at 0 with limit {@code size}.
+     * The block must be passed to {@link #submit(ByteBuffer)} or returned with {@link #release(ByteBuffer)}.
+     */
+    public static ByteBuffer acquire(int size) {
+        int sizeClass = sizeClass(size);
+        ByteBuffer block = null;
+
+        if (sizeClass >= 0) {
+            block = freeBlocks[sizeClass].poll();
+            if (block != null) {
+                pooledBytes.addAndGet(-block.capacity());
+            } else {
+                block = MemoryUtil.memAlloc(1 << (sizeClass + MIN_CLASS_SHIFT));
+            }
+        } else {
+            block = MemoryUtil.memAlloc(size);
+        }
+
+        block.clear().limit(size);
+        return block;
+    }
+
+    /**
+     * Hand a block to BGFX without copying. BGFX reads bytes position..limit; the block
+     * returns to the pool when BGFX releases it. The caller must not touch the block afterwards.
+     */
+    public static BGFXMemory submit(ByteBuffer block) {
+        long address = MemoryUtil.memAddress(block);
+        inFlight.put(address, block);
+        inFlightBytes.addAndGet(block.capacity());
+        return BGFX.bgfx_make_ref_release(block, RELEASE_CALLBACK, MemoryUtil.NULL);
+    }
+
+    /**
+     * Return a block that was acquired but never submitted.
+     */
+    public static void release(ByteBuffer block) {
+        int sizeClass = sizeClass(block.capacity());
+        boolean pooled = sizeClass >= 0
+            && block.capacity() == 1 << (sizeClass + MIN_CLASS_SHIFT)
+            && pooledBytes.get() + block.capacity() <= MAX_POOLED_BYTES;
+
+        if (pooled) {
+            pooledBytes.addAndGet(block.capacity());
+            freeBlocks[sizeClass].add(block);
+        } else {
+            MemoryUtil.memFree(block);
+        }
+    }
+
+    /**
+     * BGFX release callback: the data at {@code ptr} has been consumed.
+     */
+    private static void onRelease(long ptr) {
+        ByteBuffer block = inFlight.remove(ptr);
+        if (block == null) {
+            LOGGER.warn("BGFX released unknown upload block 0x{}", Long.toHexString(ptr));
+            return;
+        }
+        inFlightBytes.addAndGet(-block.capacity());
+        release(block);
+    }
+
+    private static int sizeClass(int size) {
+        int shift = Math.max(MIN_CLASS_SHIFT, 32 - Integer.numberOfLeadingZeros(Math.max(size, 1) - 1));
+        return shift <= MAX_CLASS_SHIFT ? shift - MIN_CLASS_SHIFT : -1;
+    }
+
+    public static long getPooledBytes() {
+        return pooledBytes.get();
+    }
+
+    public static long getInFlightBytes() {
+        return inFlightBytes.get();
+    }
+
+    /**
+     * Free all pooled blocks. Blocks still in flight are returned (and freed) by their
+     * release callbacks when BGFX shuts down.
+     */
+    public static void shutdown() {
+        for (ConcurrentLinkedQueue<ByteBuffer> queue : freeBlocks) {
+            ByteBuffer block;
+            while ((block = queue.poll()) != null) {
+                MemoryUtil.memFree(block);
+            }
+        }
+        pooledBytes.set(0);
+
+        LOGGER.info("Upload pool shutdown complete ({} bytes still in flight)", inFlightBytes.get());
+    }
+
+    private BgfxUploadPool() {
+    }
+}
@@ -0,0 +1,296 @@
+package com.vitra.render.bgfx;
+
+import com.mojang.blaze3d.vertex.VertexFormat;
+import com.mojang.blaze3d.vertex.VertexFormatElement;
+import org.lwjgl.bgfx.BGFX;
+import org.lwjgl.bgfx.BGFXVertexLayout;
+import org.lwjgl.system.MemoryStack;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+import java.util.Arrays;
+import java.util.Map;
+import java.util.concurrent.ConcurrentHashMap;
+
+/**
+ * Registry translating Minecraft VertexFormats (BLOCK, NEW_ENTITY, PARTICLE, ...) into BGFX vertex layouts.
+ *
+ * Each format is translated once into a heap-allocated BGFXVertexLayout that lives until shutdown,
+ * so its stride always matches the bytes Minecraft writes. Layout handles for
+ * bgfx_set_dynamic_vertex_buffer_with_layout() are created lazily per format.
+ *
+ * BGFX has a fixed number of layout handles (BGFX_CONFIG_MAX_VERTEX_LAYOUTS), shared with the
+ * layouts of the vertex buffers it creates. Shifted layouts (see {@link #getHandle(VertexFormat, int)})
+ * stop being created before the last RESERVED_LAYOUT_HANDLES, so buffers and plain format layouts
+ * can still get one; draws that would need another shifted layout are dropped.
+ *
+ * Uses: bgfx_vertex_layout_begin/add/skip/end(), bgfx_create_vertex_layout(), bgfx_destroy_vertex_layout()
+ */
+public final class BgfxVertexLayouts {
+    private static final Logger LOGGER = LoggerFactory.getLogger("BgfxVertexLayouts");
+
+    // Stride of the untyped layout used for buffers created before their vertex format is known.
+    // Every Minecraft vertex format has a stride that is a multiple of 4.
+    public static final int RAW_STRIDE = 4;
+
+    // BGFX_CONFIG_MAX_VERTEX_LAYOUTS
+    private static final int MAX_LAYOUT_HANDLES = 64;
+    // Kept free of shifted layouts for buffer layouts and unshifted format layouts
+    private static final int RESERVED_LAYOUT_HANDLES = 16;
+
+    private static final Map<VertexFormat, Entry> layouts = new ConcurrentHashMap<>();
+    private static volatile BGFXVertexLayout rawLayout;
+
+    // Layout handles created here; guarded by the class lock
+    private static int createdHandles = 0;
+    private static boolean exhaustedLogged = false;
+
+    /**
+     * Persistent layout and its lazily created BGFX handle.
+     */
+    private static final class Entry {
+        final BGFXVertexLayout layout;
+        volatile short handle = BGFX.BGFX_INVALID_HANDLE;
+
+        // Handles of layouts whose attributes start `shift` bytes into the vertex, indexed by shift
+        final short[] shiftedHandles;
+
+        Entry(BGFXVertexLayout layout, int stride) {
+            this.layout = layout;
+            this.shiftedHandles = new short[Math.max(stride, 1)];
+            Arrays.fill(shiftedHandles, BGFX.BGFX_INVALID_HANDLE);
+        }
+    }
+
+    /**
+     * Get the BGFX layout for a Minecraft vertex format, translating it on first use.
+     */
+    public static BGFXVertexLayout get(VertexFormat format) {
+        return entry(format).layout;
+    }
+
+    /**
+     * Stride in bytes of a vertex format, as laid out by both Minecraft and BGFX.
+     */
+    public static int stride(VertexFormat format) {
+        return format.getVertexSize();
+    }
+
+    /**
+     * Number of whole vertices of the given format contained in byteSize bytes.
+     */
+    public static int vertexCount(VertexFormat format, long byteSize) {
+        int stride = stride(format);
+        return stride > 0 ? (int) (byteSize / stride) : 0;
+    }
+
+    /**
+     * Get the BGFX vertex layout handle for a format, for bgfx_set_dynamic_vertex_buffer_with_layout().
+     */
+    public static short getHandle(VertexFormat format) {
+        Entry entry = entry(format);
+        if (!Util.isValidHandle(entry.handle)) {
+            synchronized (entry) {
+                if (!Util.isValidHandle(entry.handle)) {
+                    entry.handle = createHandle(entry.layout, MAX_LAYOUT_HANDLES);
+                    if (!Util.isValidHandle(entry.handle)) {
+                        LOGGER.error("Failed to create vertex layout handle for {}", format);
+                    }
+                }
+            }
+        }
+        return entry.handle;
+    }
+
+    /**
+     * Get a layout handle for vertices that start {@code shift} bytes past a stride boundary.
+     *
+     * BGFX addresses vertex buffers in whole vertices, so a buffer at byte offset B inside a shared
+     * arena page is bound from start vertex B / stride with every attribute moved by B % stride.
+     * The stride is unchanged; attribute offsets may run past it into the next vertex slot.
+     * Arena ranges are 16-byte aligned, so a format gets at most one shifted layout per 4 bytes of stride.
+     *
+     * @return The handle, or BGFX_INVALID_HANDLE if no more layout handles can be spared
+     */
+    public static short getHandle(VertexFormat format, int shift) {
+        if (shift == 0) {
+            return getHandle(format);
+        }
+
+        Entry entry = entry(format);
+        if (shift < 0 || shift >= entry.shiftedHandles.length) {
+            LOGGER.error("Invalid vertex layout shift {} for {}", shift, format);
+            return BGFX.BGFX_INVALID_HANDLE;
+        }
+
+        short handle = entry.shiftedHandles[shift];
+        if (!Util.isValidHandle(handle)) {
+            synchronized (entry) {
+                handle = entry.shiftedHandles[shift];
+                if (!Util.isValidHandle(handle)) {
+                    try (MemoryStack stack = MemoryStack.stackPush()) {
+                        BGFXVertexLayout shifted = BGFXVertexLayout.calloc(stack);
+                        build(shifted, format, shift);
+                        shifted.stride((short) format.getVertexSize());
+                        handle = createHandle(shifted, MAX_LAYOUT_HANDLES - RESERVED_LAYOUT_HANDLES);
+                    }
+                    // Failures are not cached; a retry only checks the handle count
+                    if (Util.isValidHandle(handle)) {
+                        entry.shiftedHandles[shift] = handle;
+                        LOGGER.debug("Created vertex layout handle for {} shifted by {} bytes: {}", format, shift, handle);
+                    }
+                }
+            }
+        }
+        return handle;
+    }
+
+    /**
+     * Create a layout handle if fewer than limit handles exist.
+     */
+    private static synchronized short createHandle(BGFXVertexLayout layout, int limit) {
+        if (createdHandles >= limit) {
+            if (!exhaustedLogged) {
+                LOGGER.error("Out of vertex layout handles ({} created), dropping draws that need more", createdHandles);
+                exhaustedLogged = true;
+            }
+            return BGFX.BGFX_INVALID_HANDLE;
+        }
+        short handle = BGFX.bgfx_create_vertex_layout(layout);
+        if (Util.isValidHandle(handle)) {
+            createdHandles++;
+        }
+        return handle;
+    }
+
+    /**
+     * Untyped layout (RAW_STRIDE bytes per element) for buffers created through
+     * GpuDevice.createBuffer(), whose vertex format is only known at draw time.
+     */
+    public static BGFXVertexLayout getRawLayout() {
+        BGFXVertexLayout layout = rawLayout;
+        if (layout == null) {
+            synchronized (BgfxVertexLayouts.class) {
+                layout = rawLayout;
+                if (layout == null) {
+                    layout = BGFXVertexLayout.calloc();
+                    BGFX.bgfx_vertex_layout_begin(layout, rendererType());
+                    BGFX.bgfx_vertex_layout_add(layout, BGFX.BGFX_ATTRIB_TEXCOORD7, 4, BGFX.BGFX_ATTRIB_TYPE_UINT8, false, true);
+                    BGFX.bgfx_vertex_layout_end(layout);
+                    rawLayout = layout;
+                }
+            }
+        }
+        return layout;
+    }
+
+    private static Entry entry(VertexFormat format) {
+        return layouts.computeIfAbsent(format, f -> new Entry(translate(f), f.getVertexSize()));
+    }
+
+    /**
+     * Translate a VertexFormat element by element, honouring Minecraft's offsets and trailing padding.
+     */
+    private static BGFXVertexLayout translate(VertexFormat format) {
+        BGFXVertexLayout layout = BGFXVertexLayout.calloc();
+        build(layout, format, 0);
+
+        if (layout.stride() != format.getVertexSize()) {
+            LOGGER.warn("Vertex layout stride {} does not match {} ({} bytes)", layout.stride(), format, format.getVertexSize());
+        } else {
+            LOGGER.debug("Registered vertex layout for {}: stride={}", format, layout.stride());
+        }
+        return layout;
+    }
+
+    /**
+     * Fill a layout with the format's elements, each placed {@code shift} bytes after its Minecraft offset.
+     */
+    private static void build(BGFXVertexLayout layout, VertexFormat format, int shift) {
+        BGFX.bgfx_vertex_layout_begin(layout, rendererType());
+
+        for (VertexFormatElement element : format.getElements()) {
+            skipTo(layout, shift + format.getOffset(element));
+
+            int attrib = attribute(element);
+            if (attrib < 0) {
+                // No BGFX attribute slot for this element - keep its bytes so the stride stays exact
+                BGFX.bgfx_vertex_layout_skip(layout, (byte) element.byteSize());
+                continue;
+            }
+
+            boolean normalized = element.usage() == VertexFormatElement.Usage.COLOR
+                || element.usage() == VertexFormatElement.Usage.NORMAL;
+            boolean asInt = !normalized && element.type() != VertexFormatElement.Type.FLOAT;
+
+            BGFX.bgfx_vertex_layout_add(layout, attrib, element.count(), attributeType(element.type()), normalized, asInt);
+        }
+
+        // NEW_ENTITY and friends pad the normal to 4 bytes
+        skipTo(layout, shift + format.getVertexSize());
+        BGFX.bgfx_vertex_layout_end(layout);
+    }
+
+    private static void skipTo(BGFXVertexLayout layout, int offset) {
+        int gap = offset - Short.toUnsignedInt(layout.stride());
+        if (gap > 0) {
+            BGFX.bgfx_vertex_layout_skip(layout, (byte) gap);
+        }
+    }
+
+    private static int attribute(VertexFormatElement element) {
+        return switch (element.usage()) {
+            case POSITION -> BGFX.BGFX_ATTRIB_POSITION;
+            case NORMAL -> BGFX.BGFX_ATTRIB_NORMAL;
+            case COLOR -> BGFX.BGFX_ATTRIB_COLOR0 + element.index();
+            // UV0 = texture, UV1 = overlay, UV2 = lightmap
+            case UV -> element.index() < 8 ? BGFX.BGFX_ATTRIB_TEXCOORD0 + element.index() : -1;
+            default -> -1;
+        };
+    }
+
+    private static int attributeType(VertexFormatElement.Type type) {
+        return switch (type) {
+            case UBYTE, BYTE -> BGFX.BGFX_ATTRIB_TYPE_UINT8;
+            case USHORT, SHORT -> BGFX.BGFX_ATTRIB_TYPE_INT16;
+            // BGFX has no 32-bit integer attribute type; same size, reinterpreted by the shader
+            default -> BGFX.BGFX_ATTRIB_TYPE_FLOAT;
+        };
+    }
+
+    private static int rendererType() {
+        return Util.isInitialized() ? BGFX.bgfx_get_renderer_type() : BGFX.BGFX_RENDERER_TYPE_NOOP;
+    }
+
+    /**
+     * Destroy layout handles and free all translated layouts. Called on renderer shutdown.
+     */
+    public static void shutdown() {
+        for (Entry entry : layouts.values()) {
+            if (Util.isValidHandle(entry.handle)) {
+                BGFX.bgfx_destroy_vertex_layout(entry.handle);
+            }
+            for (short handle : entry.shiftedHandles) {
+                if (Util.isValidHandle(handle)) {
+                    BGFX.bgfx_destroy_vertex_layout(handle);
+                }
+            }
+            entry.layout.free();
+        }
+        layouts.clear();
+        synchronized (BgfxVertexLayouts.class) {
+            createdHandles = 0;
+            exhaustedLogged = false;
+        }
+
+        if (rawLayout != null) {
+            rawLayout.free();
+            rawLayout = null;
+        }
+
+        LOGGER.info("Vertex layout registry shutdown complete");
+    }
+
+    private BgfxVertexLayouts() {
+    }
+}
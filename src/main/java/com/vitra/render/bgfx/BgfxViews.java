@@ -0,0 +1,288 @@
+package com.vitra.render.bgfx;
+
+import com.mojang.blaze3d.pipeline.RenderTarget;
+import com.mojang.blaze3d.textures.GpuTexture;
+import com.mojang.blaze3d.textures.GpuTextureView;
+import net.minecraft.client.Minecraft;
+import org.lwjgl.bgfx.BGFX;
+import org.lwjgl.system.MemoryStack;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+import java.nio.ShortBuffer;
+import java.util.HashMap;
+import java.util.Iterator;
+import java.util.Map;
+import java.util.OptionalDouble;
+import java.util.OptionalInt;
+
+/**
+ * Per-frame allocator from render passes (and texture clears) to BGFX views, with framebuffers for
+ * render targets.
+ *
+ * View 0 is the frame's backbuffer view (set up in RenderSystemMixin.flipFrame). Every render pass
+ * gets the next free view ID, so BGFX executes passes in the order Minecraft opened them. Each view
+ * is named after its pass and gets the pass's framebuffer, rect and clear values. IDs are handed out
+ * again from 1 after every bgfx_frame(). Once all views are used, further passes share the last view
+ * only if they have its target and rect and clear nothing; anything else is dropped with an error.
+ *
+ * Passes drawing into the main render target use the backbuffer, since that is what gets presented.
+ * Any other target (entity outlines, transparency targets, post chains) is rendered through a
+ * framebuffer built from its color/depth textures. Framebuffers are cached per attachment pair and
+ * destroyed with their textures.
+ *
+ * Must only be used on the render thread.
+ *
+ * Uses: bgfx_set_view_name(), bgfx_set_view_frame_buffer(), bgfx_set_view_rect(), bgfx_set_view_clear(),
+ * bgfx_set_view_scissor(), bgfx_create_frame_buffer_from_handles(), bgfx_destroy_frame_buffer()
+ */
+public final class BgfxViews {
+    private static final Logger LOGGER = LoggerFactory.getLogger("BgfxViews");
+
+    public static final int BACKBUFFER_VIEW = 0;
+    // Returned for passes that could not get a view; their draws are dropped
+    public static final int NO_VIEW = -1;
+    private static final int FIRST_PASS_VIEW = 1;
+    // BGFX_CONFIG_MAX_VIEWS
+    private static final int MAX_VIEWS = 256;
+
+    private record Attachments(short color, short depth) {
+    }
+
+    // Framebuffer and rect a view was set up with
+    private record ViewSetup(short frameBuffer, int x, int y, int width, int height) {
+    }
+
+    private static final Map<Attachments, Short> frameBuffers = new HashMap<>();
+    private static int nextView = FIRST_PASS_VIEW;
+    private static int currentView = BACKBUFFER_VIEW;
+    private static ViewSetup lastSetup = null;
+    private static boolean overflowLogged = false;
+
+    /**
+     * Allocate and configure the view for a render pass.
+     *
+     * @param name Pass name, shown in graphics debuggers
+     * @param clearColor ARGB clear color, if the pass clears color
+     * @param clearDepth Clear depth, if the pass clears depth
+     * @return View ID for all of the pass's draws, or NO_VIEW if the pass's target cannot be rendered to
+     */
+    public static int beginPass(String name, GpuTextureView colorView, GpuTextureView depthView,
+                                OptionalInt clearColor, OptionalDouble clearDepth) {
+        GpuTexture color = colorView != null ? colorView.texture() : null;
+        GpuTexture depth = depthView != null ? depthView.texture() : null;
+        int viewId = openView(name, color, depth, clearColor, clearDepth, 0, 0, -1, -1);
+        if (viewId != NO_VIEW) {
+            currentView = viewId;
+        }
+        return viewId;
+    }
+
+    /**
+     * Clear textures, or a rectangle of them, on the GPU: a view of their framebuffer whose rect is
+     * the cleared area, with a view clear and no draws. BGFX clears partial rects with its scissored
+     * clear quad. The clear runs in order with the render passes around it.
+     *
+     * @param color Color texture to clear, or null
+     * @param depth Depth texture to clear, or null
+     * @param clearColor ARGB clear color, if color is cleared
+     * @param clearDepth Clear depth, if depth is cleared
+     * @param x Left of the cleared rect
+     * @param y Bottom of the cleared rect, in GL coordinates (bottom-left origin) as Minecraft passes it
+     * @param width Width of the cleared rect, or -1 for the whole texture
+     * @param height Height of the cleared rect, or -1 for the whole texture
+     */
+    public static void clear(GpuTexture color, GpuTexture depth, OptionalInt clearColor, OptionalDouble clearDepth,
+                             int x, int y, int width, int height) {
+        GpuTexture target = color != null ? color : depth;
+        if (width >= 0 && height >= 0) {
+            // BGFX view rects have a top-left origin
+            int targetHeight = target != null ? target.getHeight(0) : Minecraft.getInstance().getWindow().getHeight();
+            y = Math.max(targetHeight - y - height, 0);
+        }
+        openView("Clear " + (target != null ? target.getLabel() : "backbuffer"), color, depth,
+            clearColor, clearDepth, x, y, width, height);
+    }
+
+    /**
+     * Allocate the next view and set its name, framebuffer, rect and clear values.
+     * A width or height of -1 covers the whole target.
+     *
+     * @return The view, or NO_VIEW if the target has no framebuffer or no view is left for it
+     * (nothing is rendered or cleared)
+     */
+    private static int openView(String name, GpuTexture color, GpuTexture depth,
+                                OptionalInt clearColor, OptionalDouble clearDepth,
+                                int x, int y, int width, int height) {
+        boolean backbuffer = rendersToBackbuffer(color, depth);
+        short frameBuffer = backbuffer ? BGFX.BGFX_INVALID_HANDLE : frameBufferFor(color, depth);
+        if (!backbuffer && !Util.isValidHandle(frameBuffer)) {
+            LOGGER.error("Skipping '{}': no frame buffer for its target", name);
+            return NO_VIEW;
+        }
+
+        if (width < 0 || height < 0) {
+            if (!backbuffer) {
+                width = color != null ? color.getWidth(0) : depth.getWidth(0);
+                height = color != null ? color.getHeight(0) : depth.getHeight(0);
+            } else {
+                com.mojang.blaze3d.platform.Window window = Minecraft.getInstance().getWindow();
+                width = window.getWidth();
+                height = window.getHeight();
+            }
+        }
+
+        int clearFlags = BGFX.BGFX_CLEAR_NONE;
+        if (clearColor.isPresent()) {
+            clearFlags |= BGFX.BGFX_CLEAR_COLOR;
+        }
+        if (clearDepth.isPresent()) {
+            clearFlags |= BGFX.BGFX_CLEAR_DEPTH;
+        }
+
+        ViewSetup setup = new ViewSetup(frameBuffer, x, y, width, height);
+        if (nextView >= MAX_VIEWS) {
+            // Out of views: the last one may take more draws for the same target and rect, but
+            // retargeting or clearing it would affect the draws it already has
+            if (clearFlags == BGFX.BGFX_CLEAR_NONE && setup.equals(lastSetup)) {
+                LOGGER.trace("'{}' -> shared view {}", name, MAX_VIEWS - 1);
+                return MAX_VIEWS - 1;
+            }
+            if (!overflowLogged) {
+                LOGGER.error("More than {} views in a frame, skipping '{}' and further passes with another target",
+                    MAX_VIEWS - FIRST_PASS_VIEW, name);
+                overflowLogged = true;
+            }
+            return NO_VIEW;
+        }
+        int viewId = nextView++;
+        lastSetup = setup;
+
+        BGFX.bgfx_set_view_name(viewId, name);
+        BGFX.bgfx_set_view_frame_buffer(viewId, frameBuffer);
+        BGFX.bgfx_set_view_rect(viewId, x, y, width, height);
+        BGFX.bgfx_set_view_scissor(viewId, 0, 0, 0, 0);
+        BGFX.bgfx_set_view_clear(viewId, clearFlags, toRgba(clearColor.orElse(0xFF000000)),
+            (float) clearDepth.orElse(1.0), (byte) 0);
+
+        // Clears happen even if the view gets no draws
+        if (clearFlags != BGFX.BGFX_CLEAR_NONE) {
+            BGFX.bgfx_encoder_touch(BgfxEncoders.main(), viewId);
+        }
+
+        LOGGER.trace("'{}' -> view {} (frame buffer: {}, {},{} {}x{})", name, viewId, frameBuffer, x, y, width, height);
+        return viewId;
+    }
+
+    /**
+     * View of the most recently opened render pass this frame, or the backbuffer view if there is none.
+     */
+    public static int currentView() {
+        return currentView;
+    }
+
+    /**
+     * Minecraft's ARGB to BGFX's RGBA.
+     */
+    public static int toRgba(int argb) {
+        return argb << 8 | argb >>> 24;
+    }
+
+    /**
+     * Whether a color/depth texture pair is rendered through the backbuffer rather than a framebuffer.
+     */
+    private static boolean rendersToBackbuffer(GpuTexture color, GpuTexture depth) {
+        return (color == null && depth == null) || isMainTarget(color, depth);
+    }
+
+    /**
+     * Framebuffer rendering into a color/depth texture pair, or BGFX_INVALID_HANDLE for the backbuffer
+     * or if none can be created (e.g. a texture without BGFX_TEXTURE_RT). Failures are not cached.
+     */
+    public static short frameBufferFor(GpuTexture color, GpuTexture depth) {
+        if (rendersToBackbuffer(color, depth)) {
+            return BGFX.BGFX_INVALID_HANDLE;
+        }
+
+        short colorHandle = color instanceof BgfxTexture texture ? texture.getBgfxHandle() : BGFX.BGFX_INVALID_HANDLE;
+        short depthHandle = depth instanceof BgfxTexture texture ? texture.getBgfxHandle() : BGFX.BGFX_INVALID_HANDLE;
+        Attachments key = new Attachments(colorHandle, depthHandle);
+        Short cached = frameBuffers.get(key);
+        if (cached != null) {
+            return cached;
+        }
+
+        short frameBuffer;
+        try (MemoryStack stack = MemoryStack.stackPush()) {
+            ShortBuffer handles = stack.mallocShort(2);
+            if (Util.isValidHandle(colorHandle)) {
+                handles.put(colorHandle);
+            }
+            if (Util.isValidHandle(depthHandle)) {
+                handles.put(depthHandle);
+            }
+            handles.flip();
+            frameBuffer = handles.hasRemaining()
+                ? BGFX.bgfx_create_frame_buffer_from_handles(handles, false)
+                : BGFX.BGFX_INVALID_HANDLE;
+        }
+
+        if (!Util.isValidHandle(frameBuffer)) {
+            LOGGER.error("Failed to create frame buffer for color {} / depth {}",
+                color != null ? color.getLabel() : "none", depth != null ? depth.getLabel() : "none");
+            return BGFX.BGFX_INVALID_HANDLE;
+        }
+        LOGGER.debug("Created frame buffer {} for color {} / depth {}", frameBuffer,
+            color != null ? color.getLabel() : "none", depth != null ? depth.getLabel() : "none");
+        frameBuffers.put(key, frameBuffer);
+        return frameBuffer;
+    }
+
+    private static boolean isMainTarget(GpuTexture color, GpuTexture depth) {
+        Minecraft minecraft = Minecraft.getInstance();
+        RenderTarget mainTarget = minecraft != null ? minecraft.getMainRenderTarget() : null;
+        // Before the main target exists everything goes to the backbuffer
+        if (mainTarget == null) {
+            return true;
+        }
+        return color != null ? color == mainTarget.getColorTexture() : depth == mainTarget.getDepthTexture();
+    }
+
+    /**
+     * Destroy the framebuffers rendering into a texture. Called before the texture is destroyed.
+     */
+    public static void releaseTexture(short textureHandle) {
+        Iterator<Map.Entry<Attachments, Short>> it = frameBuffers.entrySet().iterator();
+        while (it.hasNext()) {
+            Map.Entry<Attachments, Short> entry = it.next();
+            if (entry.getKey().color() == textureHandle || entry.getKey().depth() == textureHandle) {
+                BGFX.bgfx_destroy_frame_buffer(entry.getValue());
+                it.remove();
+            }
+        }
+    }
+
+    /**
+     * Start handing out view IDs from the first pass view again. Called after bgfx_frame().
+     */
+    public static void endFrame() {
+        nextView = FIRST_PASS_VIEW;
+        currentView = BACKBUFFER_VIEW;
+        lastSetup = null;
+    }
+
+    /**
+     * Destroy all framebuffers. Called on renderer shutdown.
+     */
+    public static void shutdown() {
+        for (short frameBuffer : frameBuffers.values()) {
+            BGFX.bgfx_destroy_frame_buffer(frameBuffer);
+        }
+        LOGGER.info("View allocator shutdown complete ({} frame buffers destroyed)", frameBuffers.size());
+        frameBuffers.clear();
+        endFrame();
+    }
+
+    private BgfxViews() {
+    }
+}
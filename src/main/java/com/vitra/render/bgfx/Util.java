@@ -8,7 +8,6 @@ import org.lwjgl.bgfx.BGFXPlatformData;
 import org.lwjgl.bgfx.BGFXResolution;
 import org.lwjgl.bgfx.BGFXTransientVertexBuffer;
 import org.lwjgl.bgfx.BGFXTransientIndexBuffer;
-import org.lwjgl.bgfx.BGFXVertexLayout;
 import org.lwjgl.system.MemoryStack;
 import org.lwjgl.system.MemoryUtil;
 import org.slf4j.Logger;
@@ -105,6 +104,9 @@ public class Util {
             resolution.reset(BGFX.BGFX_RESET_NONE); // V-Sync DISABLED for testing
             resolution.format(BGFX.BGFX_TEXTURE_FORMAT_COUNT); // Use default format
 
+            // One encoder per draw recording thread (render thread + BgfxEncoders workers)
+            init.limits().maxEncoders((short) BgfxEncoders.MAX_ENCODERS);
+
             LOGGER.info("BGFX Init: renderer=D3D12, window=0x{}, resolution={}x{}, debug={}, vsync=DISABLED",
                 Long.toHexString(windowHandle), width, height, enableDebug);
 
@@ -178,40 +180,14 @@ public class Util {
         }
     }
 
-    /**
-     * Create a simple position+texcoord+color vertex layout
-     * FIXED: Use correct renderer type for DirectX 11 instead of NOOP
-     */
-    public static BGFXVertexLayout createSimpleVertexLayout(MemoryStack stack) {
-        BGFXVertexLayout layout = BGFXVertexLayout.malloc(stack);
-        // Use DirectX 12 renderer type for proper vertex layout optimization
-        BGFX.bgfx_vertex_layout_begin(layout, BGFX.BGFX_RENDERER_TYPE_DIRECT3D12);
-
-        // Add position attribute (3 - floats)
-        BGFX.bgfx_vertex_layout_add(layout, BGFX.BGFX_ATTRIB_POSITION, 3,
-            BGFX.BGFX_ATTRIB_TYPE_FLOAT, false, false);
-
-        // Add texcoord attribute (2 - floats)
-        BGFX.bgfx_vertex_layout_add(layout, BGFX.BGFX_ATTRIB_TEXCOORD0, 2,
-            BGFX.BGFX_ATTRIB_TYPE_FLOAT, false, false);
-
-        // Add color attribute (4 bytes, normalized)
-        BGFX.bgfx_vertex_layout_add(layout, BGFX.BGFX_ATTRIB_COLOR0, 4,
-            BGFX.BGFX_ATTRIB_TYPE_UINT8, true, false);
-
-        BGFX.bgfx_vertex_layout_end(layout);
-        return layout;
-    }
-
     /**
      * Create a vertex buffer using BGFX's native functionality.
      * BGFX handles all validation internally - we just create and return the handle.
      */
     public static short createVertexBuffer(ByteBuffer data, int flags) {
-        try (MemoryStack stack = MemoryStack.stackPush()) {
+        try {
             BGFXMemory memory = BGFX.bgfx_copy(data);
-            BGFXVertexLayout layout = createSimpleVertexLayout(stack);
-            return BGFX.bgfx_create_vertex_buffer(memory, layout, flags);
+            return BGFX.bgfx_create_vertex_buffer(memory, BgfxOperations.getPositionTexColorLayout(), flags);
         } catch (Exception e) {
             LOGGER.error("Failed to create vertex buffer", e);
             return BGFX.BGFX_INVALID_HANDLE;
@@ -237,9 +213,8 @@ public class Util {
      * BGFX handles all validation internally.
      */
     public static short createDynamicVertexBuffer(int numVertices, int flags) {
-        try (MemoryStack stack = MemoryStack.stackPush()) {
-            BGFXVertexLayout layout = createSimpleVertexLayout(stack);
-            return BGFX.bgfx_create_dynamic_vertex_buffer(numVertices, layout, flags);
+        try {
+            return BGFX.bgfx_create_dynamic_vertex_buffer(numVertices, BgfxOperations.getPositionTexColorLayout(), flags);
         } catch (Exception e) {
             LOGGER.error("Failed to create dynamic vertex buffer with {} vertices", numVertices, e);
             return BGFX.BGFX_INVALID_HANDLE;
@@ -264,9 +239,8 @@ public class Util {
      * BGFX handles all allocation and validation internally.
      */
     public static boolean allocTransientVertexBuffer(BGFXTransientVertexBuffer tvb, int numVertices) {
-        try (MemoryStack stack = MemoryStack.stackPush()) {
-            BGFXVertexLayout layout = createSimpleVertexLayout(stack);
-            BGFX.bgfx_alloc_transient_vertex_buffer(tvb, numVertices, layout);
+        try {
+            BGFX.bgfx_alloc_transient_vertex_buffer(tvb, numVertices, BgfxOperations.getPositionTexColorLayout());
             return true;
         } catch (Exception e) {
             LOGGER.error("Failed to allocate transient vertex buffer", e);
@@ -302,8 +276,8 @@ public class Util {
                 return BGFX.BGFX_INVALID_HANDLE;
             }
 
-            BGFXMemory memory = BGFX.bgfx_copy(shaderData);
-            MemoryUtil.memFree(shaderData);
+            // Shader bytes were read into a pooled block; BGFX takes it without copying
+            BGFXMemory memory = BgfxUploadPool.submit(shaderData);
 
             short shaderHandle = BGFX.bgfx_create_shader(memory);
             BGFX.bgfx_set_shader_name(shaderHandle, shaderName);
@@ -409,7 +383,7 @@ public class Util {
     }
 
     /**
-     * Load shader binary from resources.
+     * Load shader binary from resources into a BgfxUploadPool block.
      */
     private static ByteBuffer loadShaderBinary(String resourcePath) {
         try (InputStream inputStream = Util.class.getResourceAsStream(resourcePath)) {
@@ -422,7 +396,7 @@ public class Util {
                 return null;
             }
 
-            ByteBuffer buffer = MemoryUtil.memAlloc(data.length);
+            ByteBuffer buffer = BgfxUploadPool.acquire(data.length);
             buffer.put(data);
             buffer.flip();
             return buffer;
@@ -16,6 +16,8 @@ import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 import java.nio.ByteBuffer;
 import java.util.List;
+import java.util.Map;
+import java.util.concurrent.ConcurrentHashMap;
 import java.util.Collections;
 import java.util.function.Supplier;
 import java.util.function.BiFunction;
@@ -28,6 +30,9 @@ public class VitraGpuDevice implements GpuDevice {
 
     private static VitraGpuDevice instance;
 
+    // Compiled pipelines by RenderPipeline identity; render passes resolve their pipeline here
+    private final Map<RenderPipeline, BgfxCompiledRenderPipeline> compiledPipelines = new ConcurrentHashMap<>();
+
     public VitraGpuDevice() {
         LOGGER.info("VitraGpuDevice created - replacing OpenGL GpuDevice with BGFX DirectX 11");
     }
@@ -146,17 +151,31 @@ public class VitraGpuDevice implements GpuDevice {
 
     @Override
     public CompiledRenderPipeline precompilePipeline(RenderPipeline pipeline) {
-        return new BgfxCompiledRenderPipeline(pipeline);
+        return getCompiledPipeline(pipeline);
     }
 
     @Override
     public CompiledRenderPipeline precompilePipeline(RenderPipeline pipeline, BiFunction<ResourceLocation, ShaderType, String> shaderResolver) {
-        return new BgfxCompiledRenderPipeline(pipeline, shaderResolver);
+        // A resolver means shaders were (re)loaded: replace any earlier compilation
+        BgfxCompiledRenderPipeline compiled = new BgfxCompiledRenderPipeline(pipeline, shaderResolver);
+        BgfxCompiledRenderPipeline previous = compiledPipelines.put(pipeline, compiled);
+        if (previous != null) {
+            previous.close();
+        }
+        return compiled;
+    }
+
+    /**
+     * Get the compiled form of a pipeline, compiling it on first use.
+     */
+    public BgfxCompiledRenderPipeline getCompiledPipeline(RenderPipeline pipeline) {
+        return compiledPipelines.computeIfAbsent(pipeline, BgfxCompiledRenderPipeline::new);
     }
 
     @Override
     public void clearPipelineCache() {
-        // TODO: Implement BGFX pipeline cache clearing
+        compiledPipelines.values().forEach(BgfxCompiledRenderPipeline::close);
+        compiledPipelines.clear();
     }
 
     @Override
@@ -6,9 +6,12 @@ import com.mojang.blaze3d.buffers.GpuBuffer;
 import com.mojang.blaze3d.buffers.GpuBufferSlice;
 import com.mojang.blaze3d.pipeline.RenderPipeline;
 import com.mojang.blaze3d.vertex.VertexFormat;
+import java.nio.ByteBuffer;
 import java.util.OptionalInt;
 import java.util.OptionalDouble;
+import java.util.ArrayList;
 import java.util.Collection;
+import java.util.List;
 import java.util.function.Supplier;
 import org.lwjgl.bgfx.BGFX;
 import org.slf4j.Logger;
@@ -23,22 +26,35 @@ public class VitraRenderPass implements RenderPass {
     private final String name;
     private final GpuTextureView colorView;
     private final GpuTextureView depthView;
-    private final OptionalInt clearColor;
-    private final OptionalDouble clearDepth;
+    // BGFX view this pass draws into, allocated in pass order (see BgfxViews); NO_VIEW drops the pass's draws
+    private final int viewId;
     private short currentProgram = (short)0;
     private BgfxBuffer currentVertexBufferObj = null;
     private BgfxBuffer currentIndexBufferObj = null;
-    private int currentVertexCount = 0;
+    private VertexFormat currentVertexFormat = null;
+    private BgfxCompiledRenderPipeline currentPipeline = null;
+    private BgfxSortKeys.Mode sortMode = BgfxSortKeys.Mode.SEQUENTIAL;
+    private long currentState = DEFAULT_STATE;
     private int currentIndexCount = 0;
     private byte currentVertexSlot = 0;
     private static short defaultProgram = (short)0;
 
+    // Smallest share of a drawMultipleIndexed() batch worth recording on a worker encoder
+    private static final int MIN_DRAWS_PER_ENCODER = 64;
+
+    // Render state for draws before any pipeline is set
+    private static final long DEFAULT_STATE = 0
+        | BGFX.BGFX_STATE_WRITE_RGB
+        | BGFX.BGFX_STATE_WRITE_A
+        | BGFX.BGFX_STATE_WRITE_Z
+        | BGFX.BGFX_STATE_DEPTH_TEST_LESS
+        | BGFX.BGFX_STATE_MSAA;
+
     public VitraRenderPass(String name, GpuTextureView colorView, GpuTextureView depthView, OptionalInt clearColor, OptionalDouble clearDepth) {
         this.name = name;
         this.colorView = colorView;
         this.depthView = depthView;
-        this.clearColor = clearColor;
-        this.clearDepth = clearDepth;
+        this.viewId = BgfxViews.beginPass(name, colorView, depthView, clearColor, clearDepth);
 
         // Initialize default shader program if needed
         initializeDefaultProgram();
@@ -51,16 +67,10 @@ public class VitraRenderPass implements RenderPass {
 
     private static synchronized void initializeDefaultProgram() {
         if (defaultProgram == (short)0) {
-            try {
-                defaultProgram = Util.loadProgram("basic");
-                if (defaultProgram != (short)0) {
-                } else {
-                    LOGGER.error("Failed to create default BGFX shader program will use invalid handle");
-                    defaultProgram = (short)0;
-                }
-            } catch (Exception e) {
-                LOGGER.error("Exception during shader program creation: {}", e.getMessage());
-                LOGGER.error("Will continue with invalid shader handle");
+            // Held for the renderer's lifetime; shared with pipelines that fall back to the same shaders
+            defaultProgram = BgfxProgramCache.acquire(BgfxProgramCache.DEFAULT_SHADER);
+            if (!Util.isValidHandle(defaultProgram)) {
+                LOGGER.error("Failed to create default BGFX shader program will use invalid handle");
                 defaultProgram = (short)0;
             }
         }
@@ -78,98 +88,169 @@ public class VitraRenderPass implements RenderPass {
 
     @Override
     public void setPipeline(RenderPipeline pipeline) {
-        // For now, use a default shader program
-        // In a full implementation, this would compile and bind the appropriate shaders
-        // currentProgram = loadShaderProgram(pipeline);
+        // Program, state word, vertex format, sort mode and sampler IDs were derived when the pipeline was precompiled
+        currentPipeline = VitraGpuDevice.getInstance().getCompiledPipeline(pipeline);
+        currentProgram = Util.isValidHandle(currentPipeline.getProgramHandle()) ? currentPipeline.getProgramHandle() : defaultProgram;
+        currentVertexFormat = currentPipeline.getVertexFormat();
+        currentState = currentPipeline.getState();
+        sortMode = currentPipeline.getSortMode();
     }
 
-    // ISSUE FIX 3: Cache uniform handles to prevent memory leaks
-    private final java.util.Map<String, Short> cachedUniformHandles = new java.util.concurrent.ConcurrentHashMap<>();
+    // Texture bound to each texture stage (BGFX_INVALID_HANDLE if none) and the sampler ID it is bound to.
+    // BGFX resets texture bindings after every submit, so they are reapplied per draw.
+    private static final int MAX_TEXTURE_STAGES = 16;
+    private final short[] boundTextures = new short[MAX_TEXTURE_STAGES];
+    private final int[] boundSamplerIds = new int[MAX_TEXTURE_STAGES];
+    private int boundTextureStages = 0;
 
     @Override
     public void bindSampler(String name, GpuTextureView textureView) {
+        if (textureView == null || !(textureView.texture() instanceof BgfxTexture bgfxTexture)) {
+            return;
+        }
 
-        if (textureView != null && textureView.texture() instanceof BgfxTexture bgfxTexture) {
-            // Get the texture handle
-            short textureHandle = bgfxTexture.getBgfxHandle();
+        // Texture stage is the sampler's position in the pipeline; undeclared samplers take the next free stage
+        int stage = currentPipeline != null ? currentPipeline.getSamplerStage(name) : -1;
+        int samplerId;
+        if (stage >= 0) {
+            samplerId = currentPipeline.getSamplerId(stage);
+        } else {
+            stage = Math.max(boundTextureStages, currentPipeline != null ? currentPipeline.getSamplerCount() : 0);
+            samplerId = BgfxUniformRegistry.internSampler(name);
+        }
 
-            // ISSUE FIX 3: Reuse existing uniform handle or create new one
-            short samplerUniform = cachedUniformHandles.computeIfAbsent(name, uniformName -> {
-                short handle = BGFX.bgfx_create_uniform(uniformName, BGFX.BGFX_UNIFORM_TYPE_SAMPLER, 1);
-                return handle;
-            });
+        if (stage >= MAX_TEXTURE_STAGES) {
+            LOGGER.warn("No texture stage left for sampler '{}'", name);
+            return;
+        }
 
-            if (samplerUniform != (short)0) {
-                // Bind texture to sampler use next available texture slot
-                byte textureSlot = 0; // Start with slot 0, increment as needed
-                BGFX.bgfx_set_texture(textureSlot, samplerUniform, textureHandle, BGFX.BGFX_SAMPLER_NONE);
+        for (int i = boundTextureStages; i < stage; i++) {
+            boundTextures[i] = BGFX.BGFX_INVALID_HANDLE;
+        }
+        boundTextures[stage] = bgfxTexture.getBgfxHandle();
+        boundSamplerIds[stage] = samplerId;
+        boundTextureStages = Math.max(boundTextureStages, stage + 1);
+    }
 
-            } else {
-                LOGGER.warn("Failed to create uniform handle for sampler '{}'", name);
+    /**
+     * Bind the pass's textures for the next submit on an encoder.
+     * Uses: bgfx_encoder_set_texture()
+     */
+    private void applyTextures(long encoder) {
+        for (int stage = 0; stage < boundTextureStages; stage++) {
+            if (Util.isValidHandle(boundTextures[stage])) {
+                BGFX.bgfx_encoder_set_texture(encoder, (byte) stage, BgfxUniformRegistry.getHandle(boundSamplerIds[stage]),
+                    boundTextures[stage], BGFX.BGFX_SAMPLER_NONE);
             }
-        } else {
         }
     }
 
+    // Uniform blocks bound for the following draws, uploaded through BgfxUniformBlocks at submit
+    private final java.util.Map<String, GpuBufferSlice> boundUniforms = new java.util.LinkedHashMap<>();
+
     @Override
     public void setUniform(String name, GpuBuffer buffer) {
         if (buffer instanceof BgfxBuffer bgfxBuffer) {
-
-            // ISSUE FIX 3: Reuse existing uniform handle or create new one
-            int uniformType = determineUniformType(name, bgfxBuffer.size());
-            short uniformHandle = cachedUniformHandles.computeIfAbsent(name, uniformName -> {
-                short handle = BGFX.bgfx_create_uniform(uniformName, uniformType, 1);
-                return handle;
-            });
-
-            if (uniformHandle != (short)0) {
-                // Note: BGFX uniforms are set per-draw call, not per buffer binding
-                // The actual uniform data will be provided during draw call submission
-                // For now, we just create the uniform handle and store the buffer reference
-            } else {
-                LOGGER.warn("Failed to create uniform handle for '{}'", name);
-            }
+            boundUniforms.put(name, bgfxBuffer.slice());
         } else {
+            LOGGER.warn("Expected BgfxBuffer for uniform '{}', got: {}", name, buffer.getClass());
         }
     }
 
     @Override
     public void setUniform(String name, GpuBufferSlice bufferSlice) {
-        if (bufferSlice.buffer() instanceof BgfxBuffer bgfxBuffer) {
-
-            // ISSUE FIX 3: Reuse existing uniform handle or create new one
-            int uniformType = determineUniformTypeBySize(name, bufferSlice.length());
-            short uniformHandle = cachedUniformHandles.computeIfAbsent(name, uniformName -> {
-                short handle = BGFX.bgfx_create_uniform(uniformName, uniformType, 1);
-                return handle;
-            });
-
-            if (uniformHandle != (short)0) {
-                // Note: BGFX uniforms are set per-draw call, not per buffer binding
-                // The actual uniform slice data will be provided during draw call submission
-                // For now, we just create the uniform handle and store the buffer slice reference
+        if (bufferSlice.buffer() instanceof BgfxBuffer) {
+            boundUniforms.put(name, bufferSlice);
+        } else {
+            LOGGER.warn("Expected BgfxBuffer for uniform '{}', got: {}", name, bufferSlice.buffer().getClass());
+        }
+    }
+
+    /**
+     * Upload uniform blocks for the next submit on an encoder. Unchanged blocks are skipped unless
+     * the pipeline's draws get sorted, which reorders them against the uploads.
+     * Uses: bgfx_encoder_set_uniform() (via BgfxUniformBlocks)
+     */
+    private void applyUniforms(long encoder, java.util.Map<String, GpuBufferSlice> uniforms) {
+        boolean force = sortMode != BgfxSortKeys.Mode.SEQUENTIAL;
+        for (java.util.Map.Entry<String, GpuBufferSlice> entry : uniforms.entrySet()) {
+            GpuBufferSlice slice = entry.getValue();
+            ByteBuffer data = ((BgfxBuffer) slice.buffer()).readShadow((int) slice.offset(), (int) slice.length());
+            if (data != null) {
+                BgfxUniformBlocks.apply(encoder, viewId, entry.getKey(), data, force);
             } else {
-                LOGGER.warn("Failed to create uniform handle for buffer slice '{}'", name);
+                LOGGER.trace("Uniform block '{}' has no CPU data, skipping", entry.getKey());
             }
         }
     }
 
+    /**
+     * Sort depth for the next submit, registering the pipeline's sort mode for the pass's view.
+     * Translucent draws are keyed by the distance of their ModelOffset; without one they keep submission order.
+     */
+    private int sortDepth(java.util.Map<String, GpuBufferSlice> uniforms) {
+        BgfxSortKeys.Mode mode = sortMode;
+        float distanceSq = 0.0f;
+        if (mode == BgfxSortKeys.Mode.TRANSLUCENT) {
+            GpuBufferSlice transforms = uniforms.get("DynamicTransforms");
+            ByteBuffer data = transforms != null
+                ? ((BgfxBuffer) transforms.buffer()).readShadow((int) transforms.offset(), (int) transforms.length())
+                : null;
+            distanceSq = data != null ? BgfxUniformBlocks.modelOffsetDistanceSq(data) : -1.0f;
+            if (distanceSq < 0.0f) {
+                mode = BgfxSortKeys.Mode.SEQUENTIAL;
+            }
+        }
+
+        BgfxSortKeys.requestViewMode(viewId, mode);
+        short texture = boundTextureStages > 0 ? boundTextures[0] : BGFX.BGFX_INVALID_HANDLE;
+        return BgfxSortKeys.key(mode, currentState, texture, distanceSq);
+    }
+
+    // Scissor for the following draws in BGFX's top-left origin, applied per draw through BgfxScissors
+    private boolean scissorEnabled = false;
+    private int scissorX, scissorY, scissorWidth, scissorHeight;
+
+    /**
+     * Clip the following draws of this pass. Minecraft passes GL coordinates (bottom-left origin),
+     * flipped here against the height of the pass's target.
+     */
     @Override
     public void enableScissor(int x, int y, int width, int height) {
-        BGFX.bgfx_set_view_scissor(0, (short)x, (short)y, (short)width, (short)height);
+        scissorEnabled = true;
+        scissorX = Math.max(x, 0);
+        scissorY = Math.max(targetHeight() - y - height, 0);
+        scissorWidth = Math.max(width, 0);
+        scissorHeight = Math.max(height, 0);
     }
 
     @Override
     public void disableScissor() {
-        // Reset scissor to full view
-        BGFX.bgfx_set_view_scissor(0, (short)0, (short)0, (short)0, (short)0);
+        scissorEnabled = false;
+    }
+
+    /**
+     * Scissor the next submit on an encoder, if the pass has a scissor enabled.
+     * Uses: bgfx_encoder_set_scissor() / bgfx_encoder_set_scissor_cached() (via BgfxScissors)
+     */
+    private void applyScissor(long encoder) {
+        if (scissorEnabled) {
+            BgfxScissors.apply(encoder, scissorX, scissorY, scissorWidth, scissorHeight);
+        }
+    }
+
+    private int targetHeight() {
+        GpuTextureView target = colorView != null ? colorView : depthView;
+        if (target != null) {
+            return target.texture().getHeight(target.baseMipLevel());
+        }
+        return net.minecraft.client.Minecraft.getInstance().getWindow().getHeight();
     }
 
     @Override
     public void setVertexBuffer(int slot, GpuBuffer buffer) {
         if (buffer instanceof BgfxBuffer bgfxBuffer) {
             currentVertexBufferObj = bgfxBuffer;
-            currentVertexCount = estimateVertexCount(bgfxBuffer);
             currentVertexSlot = (byte)slot;
             // Don't set the buffer here - it will be set right before submit in drawIndexed/draw
         } else {
@@ -181,7 +262,10 @@ public class VitraRenderPass implements RenderPass {
     public void setIndexBuffer(GpuBuffer buffer, VertexFormat.IndexType indexType) {
         if (buffer instanceof BgfxBuffer bgfxBuffer) {
             currentIndexBufferObj = bgfxBuffer;
-            boolean is32bit = indexType == VertexFormat.IndexType.INT;
+            // BGFX reads indices at the width the buffer was created with, whatever Minecraft declares
+            boolean is32bit = bgfxBuffer.getIndexSize() > 0
+                ? bgfxBuffer.getIndexSize() == 4
+                : indexType == VertexFormat.IndexType.INT;
             currentIndexCount = estimateIndexCount(bgfxBuffer, is32bit);
             // Don't set the buffer here - it will be set right before submit in drawIndexed
         } else {
@@ -191,6 +275,9 @@ public class VitraRenderPass implements RenderPass {
 
     @Override
     public void drawIndexed(int indexCount, int instanceCount, int firstIndex, int baseVertex) {
+        if (viewId == BgfxViews.NO_VIEW) {
+            return;
+        }
 
         // CRITICAL FIX: Parameter mapping issue detection
         // Minecraft's GL VitraRenderPass calls have different parameter meaning:
@@ -203,54 +290,27 @@ public class VitraRenderPass implements RenderPass {
             actualIndexCount = instanceCount;
         }
 
-        // Clear the view first if needed
-        if (clearColor.isPresent() || clearDepth.isPresent()) {
-            int clearFlags = 0;
-            int color = 0xFF000000; // Black in ABGR format for normal rendering
-            float depth = 1.0f;
-
-            if (clearColor.isPresent()) {
-                clearFlags |= BGFX.BGFX_CLEAR_COLOR;
-                color = clearColor.getAsInt();
-            }
-            if (clearDepth.isPresent()) {
-                clearFlags |= BGFX.BGFX_CLEAR_DEPTH;
-                depth = (float)clearDepth.getAsDouble();
-            }
-
-            BGFX.bgfx_set_view_clear(0, clearFlags, color, depth, (byte)0);
-        }
-
         // Only submit if we have valid geometry to draw using corrected index count
         if (actualIndexCount > 0 && currentVertexBufferObj != null && currentIndexBufferObj != null) {
+            long encoder = BgfxEncoders.main();
+
             // Set vertex buffer RIGHT BEFORE submit (BGFX requires this)
-            short vbHandle = currentVertexBufferObj.getBgfxHandle();
-            if (currentVertexBufferObj.getType() == BgfxBuffer.BufferType.DYNAMIC_VERTEX_BUFFER ||
-                currentVertexBufferObj.getType() == BgfxBuffer.BufferType.UNIFORM_BUFFER) {
-                BGFX.bgfx_set_dynamic_vertex_buffer(currentVertexSlot, vbHandle, 0, currentVertexCount);
-            } else {
-                BGFX.bgfx_set_vertex_buffer(currentVertexSlot, vbHandle, 0, currentVertexCount);
+            if (!bindVertexBuffer(encoder, currentVertexBufferObj, currentVertexSlot, 0, vertexCount(currentVertexBufferObj))) {
+                return;
             }
 
             // Set index buffer RIGHT BEFORE submit (BGFX requires this)
-            short ibHandle = currentIndexBufferObj.getBgfxHandle();
-            if (currentIndexBufferObj.getType() == BgfxBuffer.BufferType.DYNAMIC_INDEX_BUFFER) {
-                BGFX.bgfx_set_dynamic_index_buffer(ibHandle, 0, currentIndexCount);
-            } else {
-                BGFX.bgfx_set_index_buffer(ibHandle, 0, currentIndexCount);
-            }
+            // Bind only the indices drawn: shared sequential buffers are larger than any single draw
+            bindIndexBuffer(encoder, currentIndexBufferObj, 0, Math.min(actualIndexCount, currentIndexCount));
 
             // Set render state for this draw call
-            long state = 0
-                | BGFX.BGFX_STATE_WRITE_RGB
-                | BGFX.BGFX_STATE_WRITE_A
-                | BGFX.BGFX_STATE_WRITE_Z
-                | BGFX.BGFX_STATE_DEPTH_TEST_LESS
-                | BGFX.BGFX_STATE_MSAA;
-            BGFX.bgfx_set_state(state, 0);
+            BGFX.bgfx_encoder_set_state(encoder, currentState, 0);
+            applyScissor(encoder);
+            applyUniforms(encoder, boundUniforms);
+            applyTextures(encoder);
 
             // Submit the indexed draw call
-            BGFX.bgfx_submit(0, currentProgram, 0, (byte)BGFX.BGFX_DISCARD_ALL);
+            BGFX.bgfx_encoder_submit(encoder, viewId, currentProgram, sortDepth(boundUniforms), (byte)BGFX.BGFX_DISCARD_ALL);
         } else if (actualIndexCount == 0) {
             LOGGER.warn("SKIPPING DRAW actualIndexCount=0 (no geometry to render)");
         } else if (currentIndexBufferObj == null) {
@@ -260,54 +320,221 @@ public class VitraRenderPass implements RenderPass {
         }
     }
 
+    /**
+     * Draw a batch that shares program, state and textures (GUI, text, item and chunk section batches).
+     *
+     * State, scissor and textures are set once and kept across submits with BGFX_DISCARD_NONE. Each draw only
+     * sets its vertex buffer, its index range and the uniform blocks whose bytes changed. The last
+     * submit discards everything so later draws start clean.
+     *
+     * Batches of opaque pipelines are sorted by BGFX regardless of submission order, so large ones
+     * are split across worker encoders (BgfxEncoders.recordParallel). The draws' uniform uploaders,
+     * buffer reads and layout lookups still run on the render thread (prepareDraws); workers only
+     * record the prepared draws.
+     * Uses: bgfx_encoder_set_state(), bgfx_encoder_set_scissor_cached(), bgfx_encoder_set_texture(),
+     * bgfx_encoder_set_*_vertex_buffer_with_layout(), bgfx_encoder_set_*_index_buffer(), bgfx_encoder_set_uniform(),
+     * bgfx_encoder_submit()
+     */
     @Override
     public <T> void drawMultipleIndexed(Collection<Draw<T>> draws, GpuBuffer indexBuffer, VertexFormat.IndexType indexType, Collection<String> uniformNames, T uniformData) {
-        // BGFX multiple indexed draw implementation
+        if (draws.isEmpty() || viewId == BgfxViews.NO_VIEW) {
+            return;
+        }
+
+        BgfxBuffer defaultIndexBuffer = indexBuffer instanceof BgfxBuffer bgfxBuffer ? bgfxBuffer : null;
+        if (sortMode != BgfxSortKeys.Mode.OPAQUE || draws.size() < 2 * MIN_DRAWS_PER_ENCODER) {
+            recordDraws(BgfxEncoders.main(), draws, defaultIndexBuffer, uniformNames, uniformData, boundUniforms);
+            return;
+        }
+
+        java.util.Map<GpuBufferSlice, ByteBuffer> captured = new java.util.HashMap<>();
+        try {
+            List<PreparedDraw> prepared = prepareDraws(draws, defaultIndexBuffer, uniformNames, uniformData, captured);
+            int depth = sortDepth(boundUniforms);
+            BgfxEncoders.recordParallel(prepared, MIN_DRAWS_PER_ENCODER, (encoder, slice) ->
+                recordPrepared(encoder, slice, depth));
+        } finally {
+            captured.values().forEach(BgfxUploadPool::release);
+        }
     }
 
-    @Override
-    public void draw(int vertexCount, int firstVertex) {
+    /**
+     * A draw of a parallel-recorded batch, resolved on the render thread.
+     *
+     * @param uniforms Uniform block bytes for the draw, in BgfxUploadPool blocks shared by the batch
+     */
+    private record PreparedDraw(byte slot, VertexBinding vertices, IndexBinding indices,
+                                java.util.Map<String, ByteBuffer> uniforms) {
+    }
+
+    /**
+     * Run the draws' uniform uploaders and resolve their buffers on the render thread. Each uniform
+     * slice is copied out of its buffer's shadow once per batch into captured, which the caller releases
+     * after recording. Draws without geometry are dropped.
+     */
+    private <T> List<PreparedDraw> prepareDraws(Collection<Draw<T>> draws, BgfxBuffer defaultIndexBuffer,
+                                                Collection<String> uniformNames, T uniformData,
+                                                java.util.Map<GpuBufferSlice, ByteBuffer> captured) {
+        java.util.Map<String, GpuBufferSlice> uniforms = new java.util.LinkedHashMap<>(boundUniforms);
+        UniformUploader uploader = (uniformName, slice) -> {
+            if (uniformNames.contains(uniformName) && slice.buffer() instanceof BgfxBuffer) {
+                uniforms.put(uniformName, slice);
+            }
+        };
+
+        List<PreparedDraw> prepared = new ArrayList<>(draws.size());
+        for (Draw<T> draw : draws) {
+            BgfxBuffer vertexBuffer = draw.vertexBuffer() instanceof BgfxBuffer bgfxBuffer ? bgfxBuffer : null;
+            BgfxBuffer drawIndexBuffer = draw.indexBuffer() instanceof BgfxBuffer bgfxBuffer ? bgfxBuffer : defaultIndexBuffer;
+            if (vertexBuffer == null || drawIndexBuffer == null || draw.indexCount() <= 0) {
+                LOGGER.trace("SKIPPING batched draw: vertexBuffer={}, indexBuffer={}, indexCount={}",
+                    vertexBuffer, drawIndexBuffer, draw.indexCount());
+                continue;
+            }
+
+            if (draw.uniformUploaderConsumer() != null) {
+                draw.uniformUploaderConsumer().accept(uniformData, uploader);
+            }
+
+            VertexBinding vertices = vertexBinding(vertexBuffer, 0, vertexCount(vertexBuffer));
+            if (vertices == null) {
+                continue;
+            }
+
+            java.util.Map<String, ByteBuffer> blocks = new java.util.HashMap<>();
+            for (java.util.Map.Entry<String, GpuBufferSlice> entry : uniforms.entrySet()) {
+                ByteBuffer bytes = captured.computeIfAbsent(entry.getValue(), VitraRenderPass::copyShadow);
+                if (bytes != null) {
+                    blocks.put(entry.getKey(), bytes);
+                } else {
+                    LOGGER.trace("Uniform block '{}' has no CPU data, skipping", entry.getKey());
+                }
+            }
 
-        // Clear the view first if needed
-        if (clearColor.isPresent() || clearDepth.isPresent()) {
-            int clearFlags = 0;
-            int color = 0xFF000000; // Black in ABGR format for normal rendering
-            float depth = 1.0f;
+            prepared.add(new PreparedDraw((byte) draw.slot(), vertices,
+                indexBinding(drawIndexBuffer, draw.firstIndex(), draw.indexCount()),
+                java.util.Map.copyOf(blocks)));
+        }
+        return List.copyOf(prepared);
+    }
+
+    /**
+     * Copy a uniform slice's bytes into a BgfxUploadPool block, or null if its buffer has no CPU data.
+     */
+    private static ByteBuffer copyShadow(GpuBufferSlice slice) {
+        ByteBuffer data = ((BgfxBuffer) slice.buffer()).readShadow((int) slice.offset(), (int) slice.length());
+        if (data == null) {
+            return null;
+        }
+        ByteBuffer copy = BgfxUploadPool.acquire(data.remaining());
+        copy.put(0, data, data.position(), data.remaining());
+        return copy;
+    }
 
-            if (clearColor.isPresent()) {
-                clearFlags |= BGFX.BGFX_CLEAR_COLOR;
-                color = clearColor.getAsInt();
+    /**
+     * Record prepared draws on one encoder; runs on the render thread or a worker. Everything it reads is
+     * either immutable or pass state that does not change while the batch records.
+     */
+    private void recordPrepared(long encoder, List<PreparedDraw> draws, int depth) {
+        for (int i = 0; i < draws.size(); i++) {
+            PreparedDraw draw = draws.get(i);
+            draw.vertices().bind(encoder, draw.slot());
+            draw.indices().bind(encoder);
+
+            if (i == 0) {
+                BGFX.bgfx_encoder_set_state(encoder, currentState, 0);
+                applyScissor(encoder);
+                applyTextures(encoder);
             }
-            if (clearDepth.isPresent()) {
-                clearFlags |= BGFX.BGFX_CLEAR_DEPTH;
-                depth = (float)clearDepth.getAsDouble();
+            // Worker encoders get no skip cache, so every block is uploaded (see BgfxUniformBlocks.apply)
+            for (java.util.Map.Entry<String, ByteBuffer> block : draw.uniforms().entrySet()) {
+                BgfxUniformBlocks.apply(encoder, viewId, block.getKey(), block.getValue(), true);
             }
 
-            BGFX.bgfx_set_view_clear(0, clearFlags, color, depth, (byte)0);
+            byte discard = i == draws.size() - 1 ? (byte) BGFX.BGFX_DISCARD_ALL : (byte) BGFX.BGFX_DISCARD_NONE;
+            BGFX.bgfx_encoder_submit(encoder, viewId, currentProgram, depth, discard);
+        }
+    }
+
+    /**
+     * Record a drawMultipleIndexed() batch on the render thread's encoder.
+     *
+     * @param uniforms Uniform blocks bound for the draws; the draws' uploaders add to it
+     */
+    private <T> void recordDraws(long encoder, Collection<Draw<T>> draws, BgfxBuffer defaultIndexBuffer,
+                                 Collection<String> uniformNames, T uniformData,
+                                 java.util.Map<String, GpuBufferSlice> uniforms) {
+        UniformUploader uploader = (uniformName, slice) -> {
+            if (uniformNames.contains(uniformName) && slice.buffer() instanceof BgfxBuffer) {
+                uniforms.put(uniformName, slice);
+            }
+        };
+
+        boolean statePending = false;
+        int remaining = draws.size();
+        for (Draw<T> draw : draws) {
+            remaining--;
+
+            BgfxBuffer vertexBuffer = draw.vertexBuffer() instanceof BgfxBuffer bgfxBuffer ? bgfxBuffer : null;
+            BgfxBuffer drawIndexBuffer = draw.indexBuffer() instanceof BgfxBuffer bgfxBuffer ? bgfxBuffer : defaultIndexBuffer;
+            if (vertexBuffer == null || drawIndexBuffer == null || draw.indexCount() <= 0) {
+                LOGGER.trace("SKIPPING batched draw: vertexBuffer={}, indexBuffer={}, indexCount={}",
+                    vertexBuffer, drawIndexBuffer, draw.indexCount());
+                continue;
+            }
+
+            if (draw.uniformUploaderConsumer() != null) {
+                draw.uniformUploaderConsumer().accept(uniformData, uploader);
+            }
+
+            if (!bindVertexBuffer(encoder, vertexBuffer, (byte) draw.slot(), 0, vertexCount(vertexBuffer))) {
+                continue;
+            }
+            bindIndexBuffer(encoder, drawIndexBuffer, draw.firstIndex(), draw.indexCount());
+
+            if (!statePending) {
+                BGFX.bgfx_encoder_set_state(encoder, currentState, 0);
+                applyScissor(encoder);
+                applyTextures(encoder);
+            }
+            applyUniforms(encoder, uniforms);
+
+            byte discard = remaining == 0 ? (byte) BGFX.BGFX_DISCARD_ALL : (byte) BGFX.BGFX_DISCARD_NONE;
+            BGFX.bgfx_encoder_submit(encoder, viewId, currentProgram, sortDepth(uniforms), discard);
+            statePending = remaining != 0;
+        }
+
+        // The last draw was skipped: drop the state kept for it
+        if (statePending) {
+            BGFX.bgfx_encoder_discard(encoder, (byte) BGFX.BGFX_DISCARD_ALL);
+        }
+    }
+
+    @Override
+    public void draw(int vertexCount, int firstVertex) {
+        if (viewId == BgfxViews.NO_VIEW) {
+            return;
         }
 
         // Only submit if we have valid geometry to draw
         if (vertexCount > 0 && currentVertexBufferObj != null) {
             // Set vertex buffer RIGHT BEFORE submit (BGFX requires this)
-            short vbHandle = currentVertexBufferObj.getBgfxHandle();
-            if (currentVertexBufferObj.getType() == BgfxBuffer.BufferType.DYNAMIC_VERTEX_BUFFER ||
-                currentVertexBufferObj.getType() == BgfxBuffer.BufferType.UNIFORM_BUFFER) {
-                BGFX.bgfx_set_dynamic_vertex_buffer(currentVertexSlot, vbHandle, 0, currentVertexCount);
-            } else {
-                BGFX.bgfx_set_vertex_buffer(currentVertexSlot, vbHandle, 0, currentVertexCount);
+            // Draw exactly the requested range, clamped to what the buffer holds
+            long encoder = BgfxEncoders.main();
+            int available = vertexCount(currentVertexBufferObj) - firstVertex;
+            if (!bindVertexBuffer(encoder, currentVertexBufferObj, currentVertexSlot, firstVertex,
+                Math.min(vertexCount, Math.max(available, 0)))) {
+                return;
             }
 
             // Set render state for this draw call
-            long state = 0
-                | BGFX.BGFX_STATE_WRITE_RGB
-                | BGFX.BGFX_STATE_WRITE_A
-                | BGFX.BGFX_STATE_WRITE_Z
-                | BGFX.BGFX_STATE_DEPTH_TEST_LESS
-                | BGFX.BGFX_STATE_MSAA;
-            BGFX.bgfx_set_state(state, 0);
+            BGFX.bgfx_encoder_set_state(encoder, currentState, 0);
+            applyScissor(encoder);
+            applyUniforms(encoder, boundUniforms);
+            applyTextures(encoder);
 
             // Submit the non-indexed draw call
-            BGFX.bgfx_submit(0, currentProgram, 0, (byte)BGFX.BGFX_DISCARD_ALL);
+            BGFX.bgfx_encoder_submit(encoder, viewId, currentProgram, sortDepth(boundUniforms), (byte)BGFX.BGFX_DISCARD_ALL);
         } else if (vertexCount == 0) {
             LOGGER.warn("SKIPPING DRAW vertexCount=0 (no geometry to render)");
         } else if (currentVertexBufferObj == null) {
@@ -317,75 +544,118 @@ public class VitraRenderPass implements RenderPass {
 
     @Override
     public void close() {
-        // ISSUE FIX 3: Clean up cached uniform handles to prevent memory leaks
-        for (java.util.Map.Entry<String, Short> entry : cachedUniformHandles.entrySet()) {
-            try {
-                if (entry.getValue() != (short)0) {
-                    BGFX.bgfx_destroy_uniform(entry.getValue());
-                }
-            } catch (Exception e) {
-                LOGGER.warn("Failed to destroy uniform '{}': {}", entry.getKey(), e.getMessage());
-            }
-        }
-        cachedUniformHandles.clear();
+        // Uniform and sampler handles belong to BgfxUniformRegistry and outlive the pass
+        boundUniforms.clear();
+    }
+
+    // Static methods for texture management (called from VitraRenderer)
+    private static BgfxTexture lastRenderedColorTexture = null;
+
+    public static void clearLastRenderedTexture() {
+        lastRenderedColorTexture = null;
+    }
+
+    public static BgfxTexture getLastRenderedColorTexture() {
+        return lastRenderedColorTexture;
+    }
+
+    public static void setLastRenderedColorTexture(BgfxTexture texture) {
+        lastRenderedColorTexture = texture;
     }
 
     /**
-     * Determine BGFX uniform type based on uniform name and buffer size
+     * An index range resolved for binding. Arena-backed index buffers start partway into a shared
+     * index page, so the base offset is already added.
+     * Uses: bgfx_encoder_set_dynamic_index_buffer() / bgfx_encoder_set_index_buffer()
      */
-    private int determineUniformType(String name, long bufferSize) {
-        // Matrix uniforms (common in 3D graphics)
-        if (name.toLowerCase().contains("matrix") || name.toLowerCase().contains("mvp") ||
-            name.toLowerCase().contains("modelview") || name.toLowerCase().contains("projection")) {
-            return BGFX.BGFX_UNIFORM_TYPE_MAT4; // 4x4 matrix
+    private record IndexBinding(short handle, boolean dynamic, int firstIndex, int numIndices) {
+        void bind(long encoder) {
+            if (dynamic) {
+                BGFX.bgfx_encoder_set_dynamic_index_buffer(encoder, handle, firstIndex, numIndices);
+            } else {
+                BGFX.bgfx_encoder_set_index_buffer(encoder, handle, firstIndex, numIndices);
+            }
         }
+    }
 
-        // Based on buffer size (in bytes)
-        return determineUniformTypeBySize(name, bufferSize);
+    private static IndexBinding indexBinding(BgfxBuffer buffer, int firstIndex, int numIndices) {
+        if (buffer.getType() == BgfxBuffer.BufferType.DYNAMIC_INDEX_BUFFER) {
+            int indexSize = Math.max(buffer.getIndexSize(), 1);
+            return new IndexBinding(buffer.getBgfxHandle(), true, buffer.getBaseOffset() / indexSize + firstIndex, numIndices);
+        }
+        return new IndexBinding(buffer.getBgfxHandle(), false, firstIndex, numIndices);
     }
 
     /**
-     * Determine BGFX uniform type based on buffer size
+     * Bind an index range for the next submit.
      */
-    private int determineUniformTypeBySize(String name, long sizeInBytes) {
+    private static void bindIndexBuffer(long encoder, BgfxBuffer buffer, int firstIndex, int numIndices) {
+        indexBinding(buffer, firstIndex, numIndices).bind(encoder);
+    }
 
-        if (sizeInBytes >= 64) { // 4x4 matrix (16 floats * 4 bytes = 64)
-            return BGFX.BGFX_UNIFORM_TYPE_MAT4;
-        } else if (sizeInBytes >= 48) { // 3x4 matrix
-            return BGFX.BGFX_UNIFORM_TYPE_MAT3;
-        } else if (sizeInBytes >= 16) { // vec4 (4 floats * 4 bytes = 16)
-            return BGFX.BGFX_UNIFORM_TYPE_VEC4;
-        } else if (sizeInBytes >= 12) { // vec3 (3 floats * 4 bytes = 12)
-            return BGFX.BGFX_UNIFORM_TYPE_VEC4; // BGFX pads vec3 to vec4
-        } else if (sizeInBytes >= 8) { // vec2 (2 floats * 4 bytes = 8)
-            return BGFX.BGFX_UNIFORM_TYPE_VEC4; // BGFX pads vec2 to vec4
-        } else { // Default to vec4 for smaller sizes
-            return BGFX.BGFX_UNIFORM_TYPE_VEC4;
+    /**
+     * Number of whole vertices of the current pipeline's vertex format held by the buffer
+     */
+    private int vertexCount(BgfxBuffer buffer) {
+        if (currentVertexFormat != null) {
+            return BgfxVertexLayouts.vertexCount(currentVertexFormat, buffer.size());
         }
+        int stride = buffer.getVertexStride();
+        return stride > 0 ? buffer.size() / stride : 0;
     }
 
-    // Static methods for texture management (called from VitraRenderer)
-    private static BgfxTexture lastRenderedColorTexture = null;
-
-    public static void clearLastRenderedTexture() {
-        lastRenderedColorTexture = null;
+    /**
+     * A vertex range resolved for binding with the pipeline's vertex layout.
+     * Uses: bgfx_encoder_set_dynamic_vertex_buffer_with_layout() / bgfx_encoder_set_vertex_buffer_with_layout()
+     */
+    private record VertexBinding(short handle, boolean dynamic, int startVertex, int numVertices, short layoutHandle) {
+        void bind(long encoder, byte slot) {
+            if (dynamic) {
+                BGFX.bgfx_encoder_set_dynamic_vertex_buffer_with_layout(encoder, slot, handle, startVertex, numVertices, layoutHandle);
+            } else {
+                BGFX.bgfx_encoder_set_vertex_buffer_with_layout(encoder, slot, handle, startVertex, numVertices, layoutHandle);
+            }
+        }
     }
 
-    public static BgfxTexture getLastRenderedColorTexture() {
-        return lastRenderedColorTexture;
-    }
+    /**
+     * Resolve a vertex range, reinterpreted with the pipeline's vertex layout.
+     * Arena-backed buffers start at a byte offset inside a shared page, which is bound as whole
+     * vertices plus a layout shifted by the remainder.
+     *
+     * @return The binding, or null if BGFX has no layout handle left for it
+     */
+    private VertexBinding vertexBinding(BgfxBuffer buffer, int startVertex, int numVertices) {
+        short layoutHandle = BGFX.BGFX_INVALID_HANDLE;
+        if (currentVertexFormat != null) {
+            int stride = BgfxVertexLayouts.stride(currentVertexFormat);
+            int baseOffset = buffer.getBaseOffset();
+            startVertex += stride > 0 ? baseOffset / stride : 0;
+            layoutHandle = BgfxVertexLayouts.getHandle(currentVertexFormat, stride > 0 ? baseOffset % stride : 0);
+            if (!Util.isValidHandle(layoutHandle)) {
+                // Without the layout the buffer would be read with its raw creation layout
+                LOGGER.trace("SKIPPING DRAW no vertex layout for {} at offset {}", currentVertexFormat, baseOffset);
+                return null;
+            }
+        }
 
-    public static void setLastRenderedColorTexture(BgfxTexture texture) {
-        lastRenderedColorTexture = texture;
+        boolean dynamic = buffer.getType() == BgfxBuffer.BufferType.DYNAMIC_VERTEX_BUFFER ||
+            buffer.getType() == BgfxBuffer.BufferType.UNIFORM_BUFFER;
+        return new VertexBinding(buffer.getBgfxHandle(), dynamic, startVertex, numVertices, layoutHandle);
     }
 
     /**
-     * Estimate vertex count from buffer size
+     * Bind a vertex range for the next submit.
+     *
+     * @return false if there is no layout for it; nothing is bound and the draw must be skipped
      */
-    private int estimateVertexCount(BgfxBuffer buffer) {
-        // Based on our vertex layout: position(3) + texcoord(2) + color(4) = 9 floats = 36 bytes
-        int vertexStride = 36; // bytes per vertex
-        return (int)(buffer.size() / vertexStride);
+    private boolean bindVertexBuffer(long encoder, BgfxBuffer buffer, byte slot, int startVertex, int numVertices) {
+        VertexBinding binding = vertexBinding(buffer, startVertex, numVertices);
+        if (binding == null) {
+            return false;
+        }
+        binding.bind(encoder, slot);
+        return true;
     }
 
     /**